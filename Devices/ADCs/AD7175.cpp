@@ -6,6 +6,8 @@
 #include "../../Base/LLE_IOPIN.h"
 #include "../../Base/LLE_SPI.h"
 #include "AD7175_Constants.h"
+#include "../../Utilities/CRC8.h"
+#include "../../Utilities/Delay.h"
 
 namespace LowLevelEmbedded::Devices::ADCs
 {
@@ -30,39 +32,87 @@ namespace LowLevelEmbedded::Devices::ADCs
         }
     }
 
-    void AD7175::WriteRegister8(uint8_t reg, uint8_t value)
+    void AD7175::updateCache(uint8_t reg, uint32_t value)
     {
-        uint8_t wrBuf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-
-        /* Build the Command word */
-        wrBuf[0] = COMM_REG_WEN | COMM_REG_WR | reg;
+        const int slot = AD7175_CacheSlot(reg);
+        if (slot >= 0)
+        {
+            registerCache[slot] = value;
+            registerCacheValid |= (1UL << slot);
+        }
+    }
 
-        /* Fill the write buffer */
-        wrBuf[1] = value;
+    bool AD7175::checksumValid(const uint8_t* frame, size_t length) const
+    {
+        if (checksumMode == AD7175_ChecksumMode::CRC)
+        {
+            // The CRC over the data followed by its CRC is zero
+            return Utility::CRC8<AD7175_CRC_POLYNOMIAL>::Compute(frame, length) == 0;
+        }
+        if (checksumMode == AD7175_ChecksumMode::XOR)
+        {
+            uint8_t check = 0;
+            for (size_t i = 0; i < length; i++)
+            {
+                check ^= frame[i];
+            }
+            return check == 0;
+        }
+        return true;
+    }
 
-        /* Write data to the device */
-        SPIAccess->ReadWriteSPI(&wrBuf[0], 2, csID, SPIMode::Mode3);
+    uint8_t AD7175::checksumLength() const
+    {
+        return (checksumMode == AD7175_ChecksumMode::None) ? 0 : 1;
     }
 
-    void AD7175::WriteRegister16(uint8_t reg, uint16_t value)
+    uint32_t AD7175::readRegister(uint8_t reg, uint8_t size, bool* valid)
     {
-        uint8_t wrBuf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        const uint8_t command = COMM_REG_WEN | COMM_REG_RD | reg;
 
-        /* Build the Command word */
-        wrBuf[0] = COMM_REG_WEN | COMM_REG_WR | reg;
+        // With DATA_STAT the status follows the data (and precedes the checksum)
+        const int interfaceSlot = AD7175_CacheSlot(AD7175_IFMODE);
+        const uint8_t statusLength = ((reg == AD7175_DATA) && ((registerCacheValid & (1UL << interfaceSlot)) != 0) &&
+                                      ((registerCache[interfaceSlot] & INTF_MODE_REG_DATA_STAT) != 0)) ? 1 : 0;
+        const size_t length = 1 + size + statusLength + checksumLength();
 
-        /* Fill the write buffer */
-        for (int i = 0; i < 2; i++)
+        uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        bool checksumOk = false;
+        for (uint8_t attempt = 0; !checksumOk && (attempt <= CHECKSUM_RETRIES); attempt++)
         {
-            wrBuf[2 - i] = value & 0xFF;
-            value >>= 8;
+            /* Build the Command word */
+            buffer[0] = command;
+
+            /* Read data from the device */
+            SPIAccess->ReadWriteSPI(&buffer[0], length, csID, SPIMode::Mode3);
+
+            /* The checksum covers the command byte, which was overwritten by the received byte */
+            buffer[0] = command;
+            checksumOk = checksumValid(&buffer[0], length);
+            if (!checksumOk)
+            {
+                checksumErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /* Build the result */
+        uint32_t ret = 0;
+        for (int i = 1; i <= size; i++)
+        {
+            ret <<= 8;
+            ret += buffer[i];
         }
 
-        /* Write data to the device */
-        SPIAccess->ReadWriteSPI(&wrBuf[0], 3, csID, SPIMode::Mode3);
+        if (checksumOk)
+        {
+            updateCache(reg, ret);
+        }
+        lastTransferValid = checksumOk;
+        if (valid != nullptr) *valid = checksumOk;
+        return ret;
     }
 
-    void AD7175::WriteRegister24(uint8_t reg, uint32_t value)
+    bool AD7175::writeRegister(uint8_t reg, uint32_t value, uint8_t size)
     {
         uint8_t wrBuf[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 
@@ -70,67 +120,165 @@ namespace LowLevelEmbedded::Devices::ADCs
         wrBuf[0] = COMM_REG_WEN | COMM_REG_WR | reg;
 
         /* Fill the write buffer */
-        for (int i = 0; i < 3; i++)
+        uint32_t data = value;
+        for (int i = 0; i < size; i++)
+        {
+            wrBuf[size - i] = data & 0xFF;
+            data >>= 8;
+        }
+
+        /* Both checksum modes protect writes with a CRC */
+        bool checked = checksumMode != AD7175_ChecksumMode::None;
+        if (checked)
+        {
+            wrBuf[size + 1] = Utility::CRC8<AD7175_CRC_POLYNOMIAL>::Compute(&wrBuf[0], size + 1);
+        }
+        // After a write that enables continuous read the interface only clocks out conversion results,
+        // a STATUS read would return (and consume) data
+        if ((reg == AD7175_IFMODE) && ((value & INTF_MODE_REG_CONT_READ) != 0))
+        {
+            checked = false;
+        }
+
+        bool accepted = !checked;
+        for (uint8_t attempt = 0; attempt <= CHECKSUM_RETRIES; attempt++)
+        {
+            /* Write data to the device, the buffer is copied as it is overwritten with the received bytes */
+            uint8_t transfer[8];
+            for (int i = 0; i < 8; i++) transfer[i] = wrBuf[i];
+            SPIAccess->ReadWriteSPI(&transfer[0], size + 1 + checksumLength(), csID, SPIMode::Mode3);
+
+            if (reg == AD7175_IFMODE)
+            {
+                // A new checksum setting applies from the next transfer on, so this write cannot be verified
+                const auto newMode = static_cast<AD7175_ChecksumMode>((value & INTF_MODE_REG_CHECKSUM_MASK) >> 2);
+                if (newMode != checksumMode)
+                {
+                    checksumMode = newMode;
+                    accepted = true;
+                    break;
+                }
+            }
+
+            if (!checked) break;
+            /* The ADC ignores a write with a bad CRC and flags it in STATUS (cleared by reading it) */
+            bool statusValid;
+            const uint32_t status = readRegister(AD7175_STATUS, 1, &statusValid);
+            if (statusValid && ((status & STATUS_REG_CRC_ERR) == 0))
+            {
+                accepted = true;
+                break;
+            }
+            if (statusValid) checksumErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        lastTransferValid = accepted;
+        if (!accepted)
         {
-            wrBuf[3 - i] = value & 0xFF;
-            value >>= 8;
+            // The device may hold the old or the new value, read it again when next used
+            const int slot = AD7175_CacheSlot(reg);
+            if (slot >= 0) registerCacheValid &= ~(1UL << slot);
+            return false;
         }
 
-        /* Write data to the device */
-        SPIAccess->ReadWriteSPI(&wrBuf[0], 4, csID, SPIMode::Mode3);
+        updateCache(reg, value);
+        if ((reg == AD7175_ADCMODE) && ((value & ADC_MODE_REG_MODE_MASK) >= ADC_MODE_REG_MODE_INT_OFFSET_CAL))
+        {
+            // A calibration updates the offset and gain registers
+            for (uint8_t i = 0; i < SETUP_COUNT; i++)
+            {
+                registerCacheValid &= ~(1UL << AD7175_CacheSlot(AD7175_OFFSET0 + i));
+                registerCacheValid &= ~(1UL << AD7175_CacheSlot(AD7175_GAIN0 + i));
+            }
+        }
+        return true;
     }
 
-    int8_t AD7175::ReadRegister8(uint8_t reg)
+    bool AD7175::WriteRegister8(uint8_t reg, uint8_t value)
     {
-        uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        return writeRegister(reg, value, 1);
+    }
 
-        /* Build the Command word */
-        buffer[0] = COMM_REG_WEN | COMM_REG_RD | reg;
+    bool AD7175::WriteRegister16(uint8_t reg, uint16_t value)
+    {
+        return writeRegister(reg, value, 2);
+    }
+
+    bool AD7175::WriteRegister24(uint8_t reg, uint32_t value)
+    {
+        return writeRegister(reg, value, 3);
+    }
 
-        /* Read data from the device */
-        SPIAccess->ReadWriteSPI(&buffer[0], 2, csID, SPIMode::Mode3);
+    bool AD7175::LastTransferValid() const
+    {
+        return lastTransferValid;
+    }
 
-        return buffer[1];
+    int8_t AD7175::ReadRegister8(uint8_t reg)
+    {
+        return (int8_t) readRegister(reg, 1);
     }
+
     int16_t AD7175::ReadRegister16(uint8_t reg)
     {
-        int16_t ret = 0;
-        uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        return (int16_t) readRegister(reg, 2);
+    }
 
-        /* Build the Command word */
-        buffer[0] = COMM_REG_WEN | COMM_REG_RD | reg;
+    int32_t AD7175::ReadRegister24(uint8_t reg)
+    {
+        return (int32_t) readRegister(reg, 3);
+    }
 
-        /* Read data from the device */
-        SPIAccess->ReadWriteSPI(&buffer[0], 3, csID, SPIMode::Mode3);
+    uint32_t AD7175::ReadCachedRegister(uint8_t reg)
+    {
+        const int slot = AD7175_CacheSlot(reg);
+        if ((slot >= 0) && ((registerCacheValid & (1UL << slot)) != 0))
+        {
+            lastTransferValid = true;
+            return registerCache[slot];
+        }
+        return readRegister(reg, AD7175_RegisterSize(reg));
+    }
 
-        /* Build the result */
-        for (int i = 1; i < 3; i++)
+    bool AD7175::ModifyRegister(uint8_t reg, uint32_t clearMask, uint32_t setMask)
+    {
+        const uint32_t oldValue = ReadCachedRegister(reg);
+        if (!lastTransferValid) return false;
+        const uint32_t newValue = (oldValue & ~clearMask) | setMask;
+        if (newValue != oldValue)
         {
-            ret <<= 8;
-            ret += buffer[i];
+            return writeRegister(reg, newValue, AD7175_RegisterSize(reg));
         }
+        return true;
+    }
 
-        return ret;
+    void AD7175::SetChecksumMode(AD7175_ChecksumMode mode)
+    {
+        // Written with the current mode, writeRegister switches to the new one afterwards
+        ModifyRegister(AD7175_IFMODE, INTF_MODE_REG_CHECKSUM_MASK, ((uint32_t) mode << 2) & INTF_MODE_REG_CHECKSUM_MASK);
     }
-    int32_t AD7175::ReadRegister24(uint8_t reg)
+
+    AD7175_ChecksumMode AD7175::GetChecksumMode() const
     {
-        int32_t ret = 0;
-        uint8_t buffer[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        return checksumMode;
+    }
 
-        /* Build the Command word */
-        buffer[0] = COMM_REG_WEN | COMM_REG_RD | reg;
+    uint32_t AD7175::ChecksumErrors() const
+    {
+        return checksumErrors.load(std::memory_order_relaxed);
+    }
 
-        /* Read data from the device */
-        SPIAccess->ReadWriteSPI(&buffer[0], 4, csID, SPIMode::Mode3);
+    void AD7175::InvalidateCache()
+    {
+        registerCacheValid = 0;
+    }
 
-        /* Build the result */
-        for (int i = 1; i < 4; i++)
+    void AD7175::RefreshCache()
+    {
+        for (uint8_t reg : AD7175_CACHED_REGISTERS)
         {
-            ret <<= 8;
-            ret += buffer[i];
+            readRegister(reg, AD7175_RegisterSize(reg));
         }
-
-        return ret;
     }
 
     bool AD7175::ChangeAnalogPinInputOnChannel(uint8_t channelIndex, uint8_t analogPinInput)
@@ -139,21 +287,8 @@ namespace LowLevelEmbedded::Devices::ADCs
         if ((lastUsedChannel == channelIndex) && (lastUsedPin == analogPinInput)) return false;
         lastUsedPin = analogPinInput;
         // Check configuration for channel and pin input
-        uint8_t regAddress = getChannelConfigAddress(channelIndex);
-        uint16_t channelValue = ReadRegister16(regAddress);
-        // Check if channelValue is already set correctly
-        // Mask off channel analog pin input portion
-        uint16_t maskedValue = (channelValue & 0x03E0);
-        // Shift the masked bits to the right by 5 positions
-        maskedValue >>= 5;
-        if (maskedValue == analogPinInput) return true;
-        // Otherwise change the channel
-        // Adding pin to channel
-        uint16_t analogInPinMask = 0xFC1F; // Masks off the analog pin selection
-        uint16_t analogInPinSelection = analogPinInput << 5;
-        channelValue = channelValue & analogInPinMask; // Mask off pins
-        channelValue = channelValue | analogInPinSelection; // Add requested pin
-        WriteRegister16(regAddress, channelValue);
+        // Replace the analog pin selection, only written when it differs from the shadow copy
+        ModifyRegister(getChannelConfigAddress(channelIndex), CH_MAP_REG_AINPOS(0x1F), CH_MAP_REG_AINPOS(analogPinInput));
         return true;
     }
 
@@ -161,29 +296,66 @@ namespace LowLevelEmbedded::Devices::ADCs
     {
         if (this->lastUsedChannel != channelIndex) //change channel
         {
-            if (this->lastUsedChannel < 5) // turn off old channel
+            if (this->lastUsedChannel < CHANNEL_COUNT) // turn off old channel
             {
-                uint8_t regAddress = getChannelConfigAddress(this->lastUsedChannel);
-                uint16_t prevValue = ReadRegister16(regAddress);
-                prevValue &= ~CH_MAP_REG_CHEN;
-                WriteRegister16(regAddress, prevValue);
+                ModifyRegister(getChannelConfigAddress(this->lastUsedChannel), CH_MAP_REG_CHEN, 0);
             }
-            uint8_t regAddress = getChannelConfigAddress(channelIndex);
-            uint16_t prevValue = ReadRegister16(regAddress);
-            prevValue |= CH_MAP_REG_CHEN;
-            WriteRegister16(regAddress, prevValue);
+            ModifyRegister(getChannelConfigAddress(channelIndex), 0, CH_MAP_REG_CHEN);
             this->lastUsedChannel = channelIndex;
             return true;
         }
         return false;
     }
 
+    bool AD7175::ConfigureSetup(uint8_t setupIndex, uint16_t setupConfiguration, uint16_t filterConfiguration)
+    {
+        if (setupIndex >= SETUP_COUNT) return false;
+        WriteRegister16(AD7175_SETUPCON0 + setupIndex, setupConfiguration);
+        WriteRegister16(AD7175_FILTCON0 + setupIndex, filterConfiguration);
+        return true;
+    }
+
+    bool AD7175::ConfigureScan(const AD7175_ScanEntry* entries, size_t count)
+    {
+        if (count > CHANNEL_COUNT) return false;
+
+        uint16_t newChannelRegisters[CHANNEL_COUNT] = {0, 0, 0, 0};
+        uint8_t usedChannels = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const AD7175_ScanEntry& entry = entries[i];
+            if ((entry.Channel >= CHANNEL_COUNT) || (entry.Setup >= SETUP_COUNT)) return false;
+            if ((usedChannels & (1 << entry.Channel)) != 0) return false;
+            usedChannels |= (1 << entry.Channel);
+            newChannelRegisters[entry.Channel] = CH_MAP_REG_CHEN | CH_MAP_REG_SETUP(entry.Setup) |
+                                                 CH_MAP_REG_AINPOS(entry.PositiveInput) |
+                                                 CH_MAP_REG_AINNEG(entry.NegativeInput);
+        }
+
+        // Every channel register is written once, so its shadow copy is valid afterwards
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            WriteRegister16(getChannelConfigAddress(channel), newChannelRegisters[channel]);
+        }
+        scanChannelCount = (uint8_t) count;
+
+        // Single channel helpers start from a clean state
+        lastUsedChannel = (count == 1) ? entries[0].Channel : 255;
+        lastUsedPin = (count == 1) ? entries[0].PositiveInput : 255;
+        return true;
+    }
+
+    uint8_t AD7175::ScanChannelCount() const
+    {
+        return scanChannelCount;
+    }
+
     uint32_t AD7175::GetADCValue(uint8_t channelIndex)
     {
         //start ADC
-        uint16_t mode = ReadRegister16(AD7175_ADCMODE) & 0b1110011100001100;
+        uint16_t mode = ReadRegister<AD7175_ADCMODE>() & 0b1110011100001100;
         mode |= ADC_MODE_REG_MODE_SINGLE;
-        WriteRegister16(AD7175_ADCMODE, mode);
+        WriteRegister<AD7175_ADCMODE>(mode);
 
         //wait until ready
         bool ready = false;
@@ -199,32 +371,206 @@ namespace LowLevelEmbedded::Devices::ADCs
         return ReadRegister24(AD7175_DATA);
     }
 
-    void AD7175_IOPin::Clear()
+    void AD7175::StartContinuousConversion(bool useContinuousRead)
     {
-        uint16_t gpioReg = chipADC->ReadRegister16(AD7175_GPIOCON);
-        if (gpioPinNumber == 0)
+        stopRequested = false;
+        samples.Clear();
+
+        ModifyRegister(AD7175_IFMODE, INTF_MODE_REG_CONT_READ, INTF_MODE_REG_DATA_STAT);
+        ModifyRegister(AD7175_ADCMODE, ADC_MODE_REG_MODE_MASK, ADC_MODE_REG_MODE_CONTINUOUS);
+
+        if (useContinuousRead)
         {
-            uint16_t newGpioReg = (uint16_t) gpioReg & ~(0x1);
-            chipADC->WriteRegister16(AD7175_GPIOCON, newGpioReg);
-        } else
+            // Must be the last register access: from here on the interface only clocks out conversion results
+            ModifyRegister(AD7175_IFMODE, 0, INTF_MODE_REG_CONT_READ);
+        }
+        continuousReadActive = useContinuousRead;
+        continuousConversionActive = true;
+    }
+
+    void AD7175::StopContinuousConversion()
+    {
+        if (!continuousConversionActive) return;
+        if (continuousReadActive)
         {
-            uint16_t newGpioReg = (uint16_t) gpioReg & ~(0x2);
-            chipADC->WriteRegister16(AD7175_GPIOCON, newGpioReg);
+            // Leaving continuous read needs a data read command while RDY is low, OnDataReady does that
+            stopRequested = true;
+            return;
         }
+        finishContinuousConversion();
     }
 
-    void AD7175_IOPin::Set()
+    void AD7175::finishContinuousConversion()
+    {
+        continuousConversionActive = false;
+        continuousReadActive = false;
+        stopRequested = false;
+
+        // Register reads are possible again, but the shadow copies make them unnecessary
+        ModifyRegister(AD7175_ADCMODE, ADC_MODE_REG_MODE_MASK, ADC_MODE_REG_MODE_STANDBY);
+        ModifyRegister(AD7175_IFMODE, INTF_MODE_REG_CONT_READ | INTF_MODE_REG_DATA_STAT, 0);
+    }
+
+    bool AD7175::IsContinuousConversionActive() const
     {
-        uint16_t gpioReg = chipADC->ReadRegister16(AD7175_GPIOCON);
-        if (gpioPinNumber == 0)
+        return continuousConversionActive;
+    }
+
+    bool AD7175::OnDataReady()
+    {
+        if (!continuousConversionActive) return false;
+
+        AD7175_Sample sample;
+        uint8_t buffer[6] = {0, 0, 0, 0, 0, 0};
+        const bool stopping = stopRequested;
+        bool valid;
+        if (continuousReadActive && !stopping)
         {
-            uint16_t newGpioReg = (uint16_t) gpioReg | 0x1;
-            chipADC->WriteRegister16(AD7175_GPIOCON, newGpioReg);
-        } else
+            // Continuous read: data and status are clocked out without a command byte, but the checksum still
+            // covers the implied data read command in front of them
+            const size_t length = 4 + checksumLength();
+            SPIAccess->ReadWriteSPI(&buffer[1], length, csID, SPIMode::Mode3);
+            buffer[0] = COMM_REG_READ_DATA;
+            valid = checksumValid(&buffer[0], length + 1);
+            sample.Value = ((uint32_t) buffer[1] << 16) | ((uint32_t) buffer[2] << 8) | buffer[3];
+            sample.Status = buffer[4];
+        }
+        else
         {
-            uint16_t newGpioReg = (uint16_t) gpioReg | 0x2;
-            chipADC->WriteRegister16(AD7175_GPIOCON, newGpioReg);
+            // Data register read, in continuous read mode this also ends that mode
+            const size_t length = 5 + checksumLength();
+            buffer[0] = COMM_REG_READ_DATA;
+            SPIAccess->ReadWriteSPI(&buffer[0], length, csID, SPIMode::Mode3);
+            buffer[0] = COMM_REG_READ_DATA;
+            valid = checksumValid(&buffer[0], length);
+            sample.Value = ((uint32_t) buffer[1] << 16) | ((uint32_t) buffer[2] << 8) | buffer[3];
+            sample.Status = buffer[4];
         }
+        if (!valid)
+        {
+            // The result is gone once clocked out, so a corrupted one cannot be read again
+            checksumErrors.fetch_add(1, std::memory_order_relaxed);
+            if (stopping) finishContinuousConversion();
+            return false;
+        }
+        sample.Channel = STATUS_REG_CH(sample.Status);
+
+        const bool queued = samples.Push(sample);
+        if (!queued)
+        {
+            droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (SampleCallback) SampleCallback(sample);
+
+        if (stopping) finishContinuousConversion();
+        return queued;
+    }
+
+    AD7175_AcquisitionResult AD7175::Acquire(uint8_t channelIndex, std::span<uint32_t> values,
+                                             std::span<uint8_t> status, std::span<uint32_t> timestamps)
+    {
+        AD7175_AcquisitionResult result = {};
+        if ((continuousConversionActive || (channelIndex >= CHANNEL_COUNT)) ||
+            (!status.empty() && (status.size() < values.size())) ||
+            (!timestamps.empty() && (timestamps.size() < values.size())))
+        {
+            result.Error = AD7175_AcquisitionError::InvalidArgument;
+            return result;
+        }
+
+        // Only the requested channel, the shadow copies make this free when it is already the case
+        bool configured = true;
+        for (uint8_t channel = 0; channel < CHANNEL_COUNT; channel++)
+        {
+            configured = ModifyRegister(getChannelConfigAddress(channel), CH_MAP_REG_CHEN,
+                                        (channel == channelIndex) ? CH_MAP_REG_CHEN : 0) && configured;
+        }
+        lastUsedChannel = channelIndex;
+
+        configured = configured && ModifyRegister(AD7175_IFMODE, INTF_MODE_REG_CONT_READ, INTF_MODE_REG_DATA_STAT);
+        result.StartTime = Utility::timestamp ? Utility::timestamp() : 0;
+        configured = configured && ModifyRegister(AD7175_ADCMODE, ADC_MODE_REG_MODE_MASK, ADC_MODE_REG_MODE_CONTINUOUS);
+        if (!configured)
+        {
+            result.Error = AD7175_AcquisitionError::ConfigurationFailed;
+        }
+
+        const size_t length = 5 + checksumLength();
+        uint8_t buffer[6] = {0, 0, 0, 0, 0, 0};
+        bool lastReadFailed = false;
+        // Without Utility::millis the timeout is counted in polls
+        const bool useDeadline = static_cast<bool>(Utility::millis);
+        uint32_t lastResultTime = useDeadline ? Utility::millis() : 0;
+        uint32_t polls = 0;
+        while (configured && (result.Count < values.size()))
+        {
+            if (useDeadline ? ((Utility::millis() - lastResultTime) > ACQUIRE_TIMEOUT_MS) : (polls >= ACQUIRE_POLL_LIMIT))
+            {
+                result.Error = AD7175_AcquisitionError::Timeout;
+                break;
+            }
+            buffer[0] = COMM_REG_READ_DATA;
+            SPIAccess->ReadWriteSPI(&buffer[0], length, csID, SPIMode::Mode3);
+            buffer[0] = COMM_REG_READ_DATA;
+            if (!checksumValid(&buffer[0], length))
+            {
+                // The data register keeps its value until the next conversion, so the next read repeats this one
+                checksumErrors.fetch_add(1, std::memory_order_relaxed);
+                result.ChecksumErrors++;
+                lastReadFailed = true;
+                polls++;
+                continue;
+            }
+
+            // RDY is cleared by a new result and set again once it is read: a set RDY means this result was
+            // already stored (unless that read failed its checksum)
+            const uint8_t sampleStatus = buffer[4];
+            if (((sampleStatus & STATUS_REG_RDY) != 0) && !lastReadFailed)
+            {
+                polls++;
+                continue;
+            }
+            lastReadFailed = false;
+            polls = 0;
+            if (useDeadline) lastResultTime = Utility::millis();
+
+            values[result.Count] = ((uint32_t) buffer[1] << 16) | ((uint32_t) buffer[2] << 8) | buffer[3];
+            if (!status.empty()) status[result.Count] = sampleStatus;
+            if (!timestamps.empty()) timestamps[result.Count] = Utility::timestamp ? Utility::timestamp() : 0;
+            result.Status |= sampleStatus & (STATUS_REG_ADC_ERR | STATUS_REG_CRC_ERR | STATUS_REG_REG_ERR);
+            result.Count++;
+        }
+        result.EndTime = Utility::timestamp ? Utility::timestamp() : 0;
+
+        // Also after a failed configuration, the ADC may have started converting anyway
+        bool stopped = ModifyRegister(AD7175_ADCMODE, ADC_MODE_REG_MODE_MASK, ADC_MODE_REG_MODE_STANDBY);
+        stopped = ModifyRegister(AD7175_IFMODE, INTF_MODE_REG_DATA_STAT, 0) && stopped;
+        if (!stopped && (result.Error == AD7175_AcquisitionError::None))
+        {
+            result.Error = AD7175_AcquisitionError::ConfigurationFailed;
+        }
+        return result;
+    }
+
+    bool AD7175::TryGetSample(AD7175_Sample& sample)
+    {
+        return samples.Pop(sample);
+    }
+
+    uint32_t AD7175::DroppedSamples() const
+    {
+        return droppedSamples.load(std::memory_order_relaxed);
+    }
+
+    void AD7175_IOPin::Clear()
+    {
+        // Write-through cache: a single register write, no read
+        chipADC->ModifyRegister(AD7175_GPIOCON, (gpioPinNumber == 0) ? GPIO_CONF_REG_DATA0 : GPIO_CONF_REG_DATA1, 0);
+    }
+
+    void AD7175_IOPin::Set()
+    {
+        chipADC->ModifyRegister(AD7175_GPIOCON, 0, (gpioPinNumber == 0) ? GPIO_CONF_REG_DATA0 : GPIO_CONF_REG_DATA1);
     }
 
     void AD7175_IOPin::Toggle()
@@ -241,16 +587,18 @@ namespace LowLevelEmbedded::Devices::ADCs
 
     bool AD7175_IOPin::GetValue()
     {
-        uint16_t gpioReg = chipADC->ReadRegister16(AD7175_GPIOCON);
+        const uint16_t dataBit = (gpioPinNumber == 0) ? GPIO_CONF_REG_DATA0 : GPIO_CONF_REG_DATA1;
+        const uint16_t inputEnable = (gpioPinNumber == 0) ? GPIO_CONF_REG_IP_EN0 : GPIO_CONF_REG_IP_EN1;
 
-        if (gpioPinNumber == 0)
+        uint16_t gpioReg = chipADC->ReadCachedRegister(AD7175_GPIOCON);
+        if ((gpioReg & inputEnable) != 0)
         {
-            return gpioReg & 0x1;
-        } else
-        {
-            return gpioReg & 0x2;
+            // The data bit of an input follows the pin, so it has to come from the device
+            gpioReg = chipADC->ReadRegister16(AD7175_GPIOCON);
         }
+        return (gpioReg & dataBit) != 0;
     }
+
     void AD7175::Initialize()
     {
         if (initializeMethodPtr != nullptr) initializeMethodPtr();
@@ -6,10 +6,14 @@
 #define AD7175_H
 
 //CRC constants
+#include <atomic>
 #include <functional>
+#include <span>
 
 #include "../../Base/LLE_IOPIN.h"
 #include "../../Base/LLE_SPI.h"
+#include "../../Utilities/LockFreeQueue.h"
+#include "AD7175_Registers.h"
 
 namespace LowLevelEmbedded
 {
@@ -17,6 +21,51 @@ namespace LowLevelEmbedded
     {
         namespace ADCs
         {
+            /// One conversion result as read in continuous conversion mode
+            struct AD7175_Sample
+            {
+                uint8_t Channel; // channel that produced the value, taken from the appended status byte
+                uint8_t Status; // the STATUS register as appended to the data (see STATUS_REG_* bits)
+                uint32_t Value; // raw 24-bit conversion result
+            };
+
+            /// Data integrity check on the SPI interface, selected with IFMODE CRC_EN
+            enum class AD7175_ChecksumMode : uint8_t
+            {
+                None = 0,
+                XOR = 1, // XOR checksum on reads, CRC on writes
+                CRC = 2, // CRC-8 on reads and writes
+            };
+
+            /// Why AD7175::Acquire stored fewer samples than requested
+            enum class AD7175_AcquisitionError : uint8_t
+            {
+                None = 0,
+                InvalidArgument, // continuous conversion is active, the channel is out of range or a span is too small
+                ConfigurationFailed, // a channel, IFMODE or ADCMODE write failed (see LastTransferValid)
+                Timeout, // no new result within the acquisition timeout
+            };
+
+            /// Summary of a block acquisition, see AD7175::Acquire
+            struct AD7175_AcquisitionResult
+            {
+                size_t Count; // number of samples stored, less than requested when Error is set
+                uint32_t StartTime; // Utility::timestamp before the first conversion was started
+                uint32_t EndTime; // Utility::timestamp after the last sample was read
+                uint8_t Status; // error bits of all status bytes of the block OR-ed together (STATUS_REG_*_ERR)
+                uint32_t ChecksumErrors; // reads of this block that failed their checksum and were repeated
+                AD7175_AcquisitionError Error;
+            };
+
+            /// One entry of a channel scan list, see AD7175::ConfigureScan
+            struct AD7175_ScanEntry
+            {
+                uint8_t Channel; // channel register 0..3, the ADC converts enabled channels in this order
+                uint8_t PositiveInput; // AINPOS selection (see datasheet, 0..4 = AIN0..AIN4)
+                uint8_t NegativeInput; // AINNEG selection
+                uint8_t Setup; // setup 0..3 (SETUPCONx/FILTCONx) used for this channel
+            };
+
             /**
              * @class AD7175
              * @brief This class represents the AD7175 ADC device.
@@ -29,7 +78,42 @@ namespace LowLevelEmbedded
                 uint8_t lastUsedChannel;
                 uint8_t lastUsedPin;
                 uint8_t getChannelConfigAddress(uint8_t aChannelIndex);
+
+                static constexpr uint8_t CHANNEL_COUNT = 4;
+                static constexpr uint8_t SETUP_COUNT = 4;
+
+                // Write-through shadow copies of the registers in AD7175_CACHED_REGISTERS, indexed by cache slot
+                uint32_t registerCache[AD7175_CACHED_REGISTER_COUNT] = {};
+                uint32_t registerCacheValid = 0;
+                static_assert(AD7175_CACHED_REGISTER_COUNT <= 32, "registerCacheValid has one bit per cache slot");
+                void updateCache(uint8_t reg, uint32_t value);
+
+                // Number of times a transfer with a checksum error is repeated before giving up
+                static constexpr uint8_t CHECKSUM_RETRIES = 2;
+                AD7175_ChecksumMode checksumMode = AD7175_ChecksumMode::None;
+                std::atomic<uint32_t> checksumErrors { 0 };
+                bool checksumValid(const uint8_t* frame, size_t length) const;
+                uint8_t checksumLength() const;
+                // false after a transfer that failed its checksum on every retry (or a write the ADC rejected)
+                bool lastTransferValid = true;
+                uint32_t readRegister(uint8_t reg, uint8_t size, bool* valid = nullptr);
+                bool writeRegister(uint8_t reg, uint32_t value, uint8_t size);
                 std::function<void()> initializeMethodPtr;
+
+                static constexpr size_t SAMPLE_QUEUE_SIZE = 32;
+                Utility::LockFreeQueue<AD7175_Sample, SAMPLE_QUEUE_SIZE> samples;
+                std::atomic<uint32_t> droppedSamples { 0 };
+                std::atomic<bool> continuousConversionActive { false };
+                std::atomic<bool> continuousReadActive { false };
+                std::atomic<bool> stopRequested { false };
+                uint8_t scanChannelCount = 0;
+
+                // Time without a new result before Acquire gives up, longer than the slowest output data rate
+                static constexpr uint32_t ACQUIRE_TIMEOUT_MS = 1000;
+                // Data register polls without a new result before Acquire gives up, only used when Utility::millis
+                // is not set
+                static constexpr uint32_t ACQUIRE_POLL_LIMIT = 100000;
+                void finishContinuousConversion();
             public:
                 /**
                  * @brief Represents a ADC GPIO pin.
@@ -54,19 +138,179 @@ namespace LowLevelEmbedded
                  */
                 AD7175(ISPIAccess *spi_access, uint8_t cs_ID, const std::function<void()>& configureMethod);
 
-                void WriteRegister8(uint8_t reg, uint8_t value);
-                void WriteRegister16(uint8_t reg, uint16_t value);
-                void WriteRegister24(uint8_t reg, uint32_t value);
+                /// The register writes return false when the write failed its checksum on every retry, the shadow
+                /// copy of the register is invalidated in that case.
+                bool WriteRegister8(uint8_t reg, uint8_t value);
+                bool WriteRegister16(uint8_t reg, uint16_t value);
+                bool WriteRegister24(uint8_t reg, uint32_t value);
                 int8_t ReadRegister8(uint8_t reg);
                 int16_t ReadRegister16(uint8_t reg);
                 int32_t ReadRegister24(uint8_t reg);
 
+                /// False when the last register read or write failed its checksum on every retry, the value of such
+                /// a read is not cached and must not be trusted.
+                bool LastTransferValid() const;
+
+                /**
+                 * @brief Writes a register, the width is taken from AD7175_RegisterSize at compile time.
+                 *
+                 * Usage: adc.WriteRegister<AD7175_SETUPCON0>(SETUP_CONF_REG_BI_UNIPOLAR);
+                 */
+                template <uint8_t reg>
+                bool WriteRegister(uint32_t value)
+                {
+                    static_assert(AD7175_RegisterSize(reg) != 0, "Not an AD7175 register address");
+                    static_assert((reg != AD7175_STATUS) && (reg != AD7175_DATA) && (reg != AD7175_ID),
+                                  "Read-only AD7175 register");
+                    return writeRegister(reg, value, AD7175_RegisterSize(reg));
+                }
+
+                /**
+                 * @brief Reads a register, the width is taken from AD7175_RegisterSize at compile time.
+                 *
+                 * Shadowed registers are returned from the cache, only the first access reads the device.
+                 */
+                template <uint8_t reg>
+                uint32_t ReadRegister()
+                {
+                    static_assert(AD7175_RegisterSize(reg) != 0, "Not an AD7175 register address");
+                    if constexpr (AD7175_CacheSlot(reg) >= 0)
+                    {
+                        return ReadCachedRegister(reg);
+                    }
+                    else
+                    {
+                        return readRegister(reg, AD7175_RegisterSize(reg));
+                    }
+                }
+
+                /// Returns the shadow copy of a register, the device is only read when the copy is not valid
+                /// (or the register is not shadowed at all).
+                uint32_t ReadCachedRegister(uint8_t reg);
+
+                /// Clears and sets bits in a register using its shadow copy. The register is written only when its
+                /// value changes, and never read when the shadow copy is valid.
+                /// \return false if the register could not be read or the write failed
+                bool ModifyRegister(uint8_t reg, uint32_t clearMask, uint32_t setMask);
+
+                /// Marks all shadow copies invalid, e.g. after a reset of the ADC. They are re-read when next used.
+                void InvalidateCache();
+
+                /// Reads all shadowed registers from the device. Not possible while continuous read mode is active.
+                void RefreshCache();
+
+                /**
+                 * @brief Enables or disables the checksum byte on all SPI transfers (IFMODE CRC_EN).
+                 *
+                 * With a checksum enabled every register and data read is verified and repeated on a mismatch, every
+                 * register write carries a CRC and is followed by a STATUS read to check that the ADC accepted it
+                 * (except the IFMODE write that enables continuous read, after it STATUS can no longer be read).
+                 * A transfer that still fails after the retries is reported by the return value or LastTransferValid
+                 * and is not cached.
+                 * Conversion results read in OnDataReady cannot be repeated, a corrupted one is dropped.
+                 * A reset of the ADC disables the checksum again, call InvalidateCache and this method after one.
+                 */
+                void SetChecksumMode(AD7175_ChecksumMode mode);
+
+                AD7175_ChecksumMode GetChecksumMode() const;
+
+                /// The number of transfers that failed their checksum (including the ones that succeeded on a retry)
+                uint32_t ChecksumErrors() const;
+
                 /// Returns true if the channel's analog pin is changed
                 bool ChangeAnalogPinInputOnChannel(uint8_t channelIndex, uint8_t analogPinInput);
                 /// Returns true if the channel is changed
                 bool ChangeChannel(uint8_t channelIndex);
                 uint32_t GetADCValue(uint8_t channelIndex);
                 void Initialize();
+
+                /**
+                 * @brief Programs one setup: its SETUPCONx and FILTCONx registers.
+                 * @param setupIndex setup 0..3
+                 * @param setupConfiguration SETUPCONx value (see SETUP_CONF_REG_* bits)
+                 * @param filterConfiguration FILTCONx value (see FILT_CONF_REG_* bits)
+                 * @return false if the setup index is out of range
+                 */
+                bool ConfigureSetup(uint8_t setupIndex, uint16_t setupConfiguration, uint16_t filterConfiguration);
+
+                /**
+                 * @brief Programs all channel registers for a scan: the listed channels are enabled, all others disabled.
+                 *
+                 * The registers are written once and shadowed, no register is read. In continuous conversion mode
+                 * (see StartContinuousConversion) the ADC then cycles through the enabled channels by itself, every
+                 * sample carries the channel it belongs to.
+                 *
+                 * @param entries the scan list, every channel may appear only once
+                 * @param count the number of entries (at most 4)
+                 * @return false if the scan list is invalid, nothing is written in that case
+                 */
+                bool ConfigureScan(const AD7175_ScanEntry* entries, size_t count);
+
+                /// The number of channels enabled by the last ConfigureScan call
+                uint8_t ScanChannelCount() const;
+
+                /**
+                 * @brief Starts continuous conversion on the enabled channels with the status byte appended to the data.
+                 *
+                 * Every conversion result is then read with a single SPI transfer in OnDataReady, the channel is taken
+                 * from the appended status so sequenced channels can be told apart.
+                 *
+                 * @param useContinuousRead also enable the continuous read mode (CONTREAD): the data is clocked out
+                 *        without a command byte. In this mode no register can be accessed until the conversion is
+                 *        stopped, and the chip select must stay asserted between samples so DOUT/RDY keeps signalling
+                 *        data ready.
+                 */
+                void StartContinuousConversion(bool useContinuousRead = true);
+
+                /**
+                 * @brief Stops continuous conversion and puts the ADC in standby.
+                 *
+                 * Continuous read mode can only be left while a new result is ready, so in that mode the stop is
+                 * completed by the next OnDataReady call (which still delivers that last sample).
+                 */
+                void StopContinuousConversion();
+
+                /// True between StartContinuousConversion and the completion of StopContinuousConversion
+                bool IsContinuousConversionActive() const;
+
+                /**
+                 * @brief Reads one conversion result, call this from the DOUT/RDY (MISO) falling edge interrupt.
+                 *
+                 * The sample is stored in the sample queue and passed to SampleCallback when it is assigned.
+                 * @return false if continuous conversion is not active, the sample failed its checksum or the sample queue
+                 *         was full
+                 */
+                bool OnDataReady();
+
+                /// Takes the oldest sample from the queue filled by OnDataReady.
+                /// \return false if no sample is available
+                bool TryGetSample(AD7175_Sample& sample);
+
+                /// The number of samples lost because the sample queue was full
+                uint32_t DroppedSamples() const;
+
+                /// Optional, called from OnDataReady (interrupt context) for every sample read
+                std::function<void(const AD7175_Sample&)> SampleCallback;
+
+                /**
+                 * @brief Converts one channel continuously until the caller's buffer is full.
+                 *
+                 * Only the requested channel is enabled (a configured scan is left disabled). Every result is fetched
+                 * with one data register read from a pre-built command buffer, the status appended to the data tells
+                 * whether it is a new conversion, so no separate STATUS polling is needed. The ADC is put in standby
+                 * afterwards. Not available while continuous conversion (StartContinuousConversion) is active.
+                 *
+                 * The acquisition is aborted when a configuration write fails, or when no new result arrives within
+                 * one second (measured with Utility::millis), the result then tells why.
+                 *
+                 * @param channelIndex the channel 0..3 to convert
+                 * @param values receives the raw 24-bit results
+                 * @param status optional, receives the status byte of every result (same size as values or empty)
+                 * @param timestamps optional, receives the Utility::timestamp of every result (same size as values or
+                 *        empty)
+                 */
+                AD7175_AcquisitionResult Acquire(uint8_t channelIndex, std::span<uint32_t> values,
+                                                 std::span<uint8_t> status = {}, std::span<uint32_t> timestamps = {});
             };
 
             class AD7175_IOPin : public LowLevelEmbedded::IOPIN
@@ -5,60 +5,20 @@
 #ifndef AD7175_CONSTANTS_H
 #define AD7175_CONSTANTS_H
 
+#include "AD7175_Registers.h"
+
 //CRC constants
 #define AD7175_CRC_POLYNOMIAL 0x07 // x^8 + x^2 + x +1 (MSB first)
 #define AD7175_CRC_CHECK_CODE 0xF3
 
-// Communications register. Write to me first before reading/writing from the register
-#define AD7175_COMMS 0x00
-
-// Status register.
-#define AD7175_STATUS 0x00
-
-// Set conversion mode (single or continuous), standby/power down, calibration, clock source selection and internal reference
-#define AD7175_ADCMODE 0x01
-
-#define AD7175_IFMODE 0x02
-#define AD7175_REGCHECK 0x03
-#define AD7175_DATA 0x04
-#define AD7175_GPIOCON 0x06
-#define AD7175_ID 0x07
-
-// Channel Registers
-#define AD7175_CH0 0x10
-#define AD7175_CH1 0x11
-#define AD7175_CH2 0x12
-#define AD7175_CH3 0x13
-
-// Selects Output Coding and Reference Voltage
-#define AD7175_SETUPCON0 0x20
-#define AD7175_SETUPCON1 0x21
-#define AD7175_SETUPCON2 0x22
-#define AD7175_SETUPCON3 0x23
-
-// Selects the Digital Filter
-#define AD7175_FILTCON0 0x28
-#define AD7175_FILTCON1 0x29
-#define AD7175_FILTCON2 0x2A
-#define AD7175_FILTCON3 0x2B
-
-// Offset Calibration Coefficients
-#define AD7175_OFFSET0 0x30
-#define AD7175_OFFSET1 0x30
-#define AD7175_OFFSET2 0x30
-#define AD7175_OFFSET3 0x30
-
-// Gain Calibration Coefficients
-#define AD7175_GAIN0 0x38
-#define AD7175_GAIN1 0x39
-#define AD7175_GAIN2 0x3A
-#define AD7175_GAIN3 0x3B
-
 /* Communication Register bits */
 #define COMM_REG_WEN    (0 << 7)
 #define COMM_REG_WR     (0 << 6)
 #define COMM_REG_RD     (1 << 6)
 
+// Command byte that reads the data register, also used to leave continuous read mode
+#define COMM_REG_READ_DATA (COMM_REG_WEN | COMM_REG_RD | AD7175_DATA)
+
 /* Status Register bits */
 #define STATUS_REG_RDY      (1 << 7)
 #define STATUS_REG_ADC_ERR  (1 << 6)
@@ -72,14 +32,20 @@
 #define ADC_MODE_REG_DELAY(x)       (((x) & 0x7) << 8)
 #define ADC_MODE_REG_DELAY_1ms      ADC_MODE_REG_DELAY(7)
 #define ADC_MODE_REG_MODE(x)        (((x) & 0x7) << 4)
+#define ADC_MODE_REG_MODE_CONTINUOUS   ADC_MODE_REG_MODE(0)
 #define ADC_MODE_REG_MODE_SINGLE       ADC_MODE_REG_MODE(1)
-#define ADC_MODE_REG_CLKSEL(x))     (((x) & 0x3) << 2)
+#define ADC_MODE_REG_MODE_STANDBY      ADC_MODE_REG_MODE(2)
+#define ADC_MODE_REG_MODE_MASK         ADC_MODE_REG_MODE(7)
+#define ADC_MODE_REG_MODE_INT_OFFSET_CAL ADC_MODE_REG_MODE(4) // this and all higher modes are calibrations
+#define ADC_MODE_REG_CLKSEL(x)     (((x) & 0x3) << 2)
 
 /* Interface Mode Register bits */
 #define INTF_MODE_REG_DOUT_RESET    (1 << 8)
 #define INTF_MODE_REG_CONT_READ     (1 << 7)
 #define INTF_MODE_REG_DATA_STAT     (1 << 6)
-#define INTF_MODE_REG_CRC_EN        (0x02 << 2)
+#define INTF_MODE_REG_XOR_EN        (0x01 << 2) // XOR checksum on reads, CRC on writes
+#define INTF_MODE_REG_CRC_EN        (0x02 << 2) // CRC on reads and writes
+#define INTF_MODE_REG_CHECKSUM_MASK (0x03 << 2)
 #define INTF_MODE_REG_CRC_STAT(x)   (((x) & INTF_MODE_REG_CRC_EN) == INTF_MODE_REG_CRC_EN)
 
 /* GPIO Configuration Register */
@@ -0,0 +1,113 @@
+#ifndef AD7175_REGISTERS_H
+#define AD7175_REGISTERS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LowLevelEmbedded
+{
+    namespace Devices
+    {
+        namespace ADCs
+        {
+            /// AD7175 register addresses, the bit definitions of the registers are in AD7175_Constants.h
+            enum AD7175_Register : uint8_t
+            {
+                // Communications register. Write to me first before reading/writing from the register
+                AD7175_COMMS = 0x00,
+                // Status register.
+                AD7175_STATUS = 0x00,
+                // Set conversion mode (single or continuous), standby/power down, calibration, clock source
+                // selection and internal reference
+                AD7175_ADCMODE = 0x01,
+                AD7175_IFMODE = 0x02,
+                AD7175_REGCHECK = 0x03,
+                AD7175_DATA = 0x04,
+                AD7175_GPIOCON = 0x06,
+                AD7175_ID = 0x07,
+
+                // Channel Registers
+                AD7175_CH0 = 0x10,
+                AD7175_CH1 = 0x11,
+                AD7175_CH2 = 0x12,
+                AD7175_CH3 = 0x13,
+
+                // Selects Output Coding and Reference Voltage
+                AD7175_SETUPCON0 = 0x20,
+                AD7175_SETUPCON1 = 0x21,
+                AD7175_SETUPCON2 = 0x22,
+                AD7175_SETUPCON3 = 0x23,
+
+                // Selects the Digital Filter
+                AD7175_FILTCON0 = 0x28,
+                AD7175_FILTCON1 = 0x29,
+                AD7175_FILTCON2 = 0x2A,
+                AD7175_FILTCON3 = 0x2B,
+
+                // Offset Calibration Coefficients
+                AD7175_OFFSET0 = 0x30,
+                AD7175_OFFSET1 = 0x31,
+                AD7175_OFFSET2 = 0x32,
+                AD7175_OFFSET3 = 0x33,
+
+                // Gain Calibration Coefficients
+                AD7175_GAIN0 = 0x38,
+                AD7175_GAIN1 = 0x39,
+                AD7175_GAIN2 = 0x3A,
+                AD7175_GAIN3 = 0x3B
+            };
+
+            // Register width in bytes, 0 for an address that is not a register.
+            // The data register is one byte longer when IFMODE DATA_STAT appends the status to it.
+            constexpr uint8_t AD7175_RegisterSize(uint8_t reg)
+            {
+                switch (reg)
+                {
+                    case AD7175_STATUS:
+                        return 1;
+                    case AD7175_REGCHECK:
+                    case AD7175_DATA:
+                        return 3;
+                    case AD7175_ADCMODE:
+                    case AD7175_IFMODE:
+                    case AD7175_GPIOCON:
+                    case AD7175_ID:
+                        return 2;
+                    default:
+                        break;
+                }
+                if ((reg >= AD7175_CH0) && (reg <= AD7175_CH3)) return 2;
+                if ((reg >= AD7175_SETUPCON0) && (reg <= AD7175_SETUPCON3)) return 2;
+                if ((reg >= AD7175_FILTCON0) && (reg <= AD7175_FILTCON3)) return 2;
+                if ((reg >= AD7175_OFFSET0) && (reg <= AD7175_OFFSET3)) return 3;
+                if ((reg >= AD7175_GAIN0) && (reg <= AD7175_GAIN3)) return 3;
+                return 0;
+            }
+
+            // Configuration registers shadowed by the driver: they only change when written (or by a calibration).
+            // The position in this list is the cache slot.
+            inline constexpr AD7175_Register AD7175_CACHED_REGISTERS[] = {
+                AD7175_ADCMODE, AD7175_IFMODE, AD7175_GPIOCON,
+                AD7175_CH0, AD7175_CH1, AD7175_CH2, AD7175_CH3,
+                AD7175_SETUPCON0, AD7175_SETUPCON1, AD7175_SETUPCON2, AD7175_SETUPCON3,
+                AD7175_FILTCON0, AD7175_FILTCON1, AD7175_FILTCON2, AD7175_FILTCON3,
+                AD7175_OFFSET0, AD7175_OFFSET1, AD7175_OFFSET2, AD7175_OFFSET3,
+                AD7175_GAIN0, AD7175_GAIN1, AD7175_GAIN2, AD7175_GAIN3
+            };
+            inline constexpr size_t AD7175_CACHED_REGISTER_COUNT =
+                sizeof(AD7175_CACHED_REGISTERS) / sizeof(AD7175_CACHED_REGISTERS[0]);
+
+            // Cache slot of a register, -1 if the register is not shadowed
+            constexpr int AD7175_CacheSlot(uint8_t reg)
+            {
+                for (size_t i = 0; i < AD7175_CACHED_REGISTER_COUNT; i++)
+                {
+                    if (AD7175_CACHED_REGISTERS[i] == reg) return (int) i;
+                }
+                return -1;
+            }
+        }
+    }
+}
+
+#endif //AD7175_REGISTERS_H
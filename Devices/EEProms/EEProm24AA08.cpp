@@ -3,24 +3,12 @@
 //
 
 #include "EEProm24AA08.h"
+#include "../../Utilities/Delay.h"
 #include <stdexcept>
 #include <stdint.h>
 
 namespace LowLevelEmbedded::Devices::EEProm
 {
-    void EEProm24AA08::initWriteBuffers()
-    {
-        WriteBuffer->Clear();
-    }
-
-    void EEProm24AA08::initReadBuffers()
-    {
-        for(int i = 0; i < 4; i++)
-        {
-            MainReadData[i].clear();
-        }
-    }
-
     uint8_t EEProm24AA08::getBlockForVirtualAddress(uint16_t virtualAddress)
     {
         if (virtualAddress < 256) return 0;
@@ -33,93 +21,162 @@ namespace LowLevelEmbedded::Devices::EEProm
         return 0;
     }
 
-    bool EEProm24AA08::ackPolling(int8_t blockIndex)
+    bool EEProm24AA08::WriteBytes(uint16_t address, uint8_t *data, size_t length)
     {
-        int i = 0;
-        while (i < 40) // Poll on the device 20 times (50ms timeout for each)
+        if (!StartWriteBytes(address, data, length))
         {
-            uint8_t i2cAddress = WriteBuffer->Blocks[blockIndex]->BlockWriteAddress;
-            if (i2cAccess->I2C_IsDeviceReady(i2cAddress))
-            {
-                return true;
-            }
-            i++;
+            return false;
         }
-        return false;
+        return completeWrite();
     }
 
+    bool EEProm24AA08::StartWriteBytes(uint16_t address, uint8_t *data, size_t length)
+    {
+        if (writing)
+        {
+            return false;
+        }
+        if (address + length > MEMORY_SIZE)
+        {
+#ifndef LOWLEVELCPPCLASSES_DISABLE_EXCEPTIONS
+            throw std::invalid_argument("Received Bad Address Value! Addresses are between 0-1023");
+#endif
+            return false;
+        }
+        if (length == 0)
+        {
+            return true;
+        }
 
-    void EEProm24AA08::WriteBytes(uint16_t address, uint8_t *data, size_t length)
+        writeData = data;
+        writeAddress = address;
+        writeLength = length;
+        writeOffset = 0;
+        writing = writeNextPage();
+        return writing;
+    }
+
+    bool EEProm24AA08::writeNextPage()
     {
-        // Clear Write buffers
-        initWriteBuffers();
+        const uint16_t currentAddress = writeAddress + writeOffset;
+        writeBlockIndex = getBlockForVirtualAddress(currentAddress);
 
-        // Fill Data
-        WriteBuffer->AddData(address, data, length);
+        // The device wraps around inside the page, so stop at the next page boundary
+        size_t pageLength = PAGE_SIZE - (currentAddress % PAGE_SIZE);
+        if (pageLength > writeLength - writeOffset) pageLength = writeLength - writeOffset;
 
-        // Transmit all write buffers for each block
-        for (auto block: WriteBuffer->Blocks)
+        if (!i2cAccess->I2C_Mem_Write(USED_I2C_ADDRESSES[writeBlockIndex], currentAddress % BLOCK_SIZE, 1,
+                                      writeData + writeOffset, pageLength))
         {
-            uint8_t i2cAddress = block->BlockWriteAddress;
-            for (auto page: block->PageWriteBuffers)
-            {
-                i2cAccess->I2C_WriteMethod(i2cAddress, page.data(), page.size());
-                while (!ackPolling(block->BlockNumber));
-            }
+            return false;
         }
+        writeOffset += pageLength;
+        writeCycleStart = Utility::millis ? Utility::millis() : 0;
+        writePolls = 0;
+        return true;
     }
 
-    void EEProm24AA08::ReadBytes(uint16_t address, uint8_t*& data, size_t length)
+    EEProm24AA08_WriteStatus EEProm24AA08::ContinueWrite()
     {
-        // Clear Write buffers
-        initReadBuffers();
-        for (int i = 0; i < length; i++)
+        if (!writing)
         {
-            currentBlockIndex = getBlockForVirtualAddress(address + i);
-            blockAddressDataPointer = (address + i) % 256;
+            return EEProm24AA08_WriteStatus::Done;
+        }
 
-            // Access block
-            if (MainReadData[currentBlockIndex].size() == 0)
+        // The device does not acknowledge its address until the write cycle is complete
+        if (!i2cAccess->I2C_IsDeviceReady(USED_I2C_ADDRESSES[writeBlockIndex]))
+        {
+            const bool expired = Utility::millis
+                ? (Utility::millis() - writeCycleStart >= EEPROM24AA08_WRITE_CYCLE_TIMEOUT_MS)
+                : (++writePolls >= EEPROM24AA08_ACK_POLL_ATTEMPTS);
+            if (expired)
             {
-                // push address
-                MainReadData[currentBlockIndex].push_back(blockAddressDataPointer);
-
-                // Add a length
-                MainReadData[currentBlockIndex].push_back(0);
+                writing = false;
+                return EEProm24AA08_WriteStatus::Error;
             }
-
-            // Increment read length on this block
-            MainReadData[currentBlockIndex][1]++;
+            return EEProm24AA08_WriteStatus::Busy;
         }
 
-        // Read all data buffers for each block
-        int dataIndex = 0;
-        for (int i = 0; i < 4; i++)
+        if (writeOffset >= writeLength)
         {
-            if (MainReadData[i].size() == 0) continue;
-
-            uint8_t currentBlockAddressPointer = MainReadData[i][0];
-            uint8_t currentBlockReadLength = MainReadData[i][1];
+            writing = false;
+            return EEProm24AA08_WriteStatus::Done;
+        }
+        if (!writeNextPage())
+        {
+            writing = false;
+            return EEProm24AA08_WriteStatus::Error;
+        }
+        return EEProm24AA08_WriteStatus::Busy;
+    }
 
-            uint8_t i2cAddressRead = ReadBufferAddresses[i];
+    bool EEProm24AA08::IsWriting() const
+    {
+        return writing;
+    }
 
-            // Sequential Read procedure
-            uint8_t tempData[currentBlockReadLength];
-            ackPolling(i); // Wait for block to be ready
-            if (!i2cAccess->I2C_Mem_Read(i2cAddressRead, currentBlockAddressPointer, 1, tempData, currentBlockReadLength))
+    bool EEProm24AA08::completeWrite()
+    {
+        uint32_t backoff = 100;
+        size_t offset = writeOffset;
+        while (true)
+        {
+            const EEProm24AA08_WriteStatus status = ContinueWrite();
+            if (status != EEProm24AA08_WriteStatus::Busy)
             {
+                return status == EEProm24AA08_WriteStatus::Done;
+            }
+            if (writeOffset != offset)
+            {
+                // Next page sent, start over with short delays
+                offset = writeOffset;
+                backoff = 100;
+            }
+            if (Utility::Delay_us)
+            {
+                Utility::Delay_us(backoff);
+                if (backoff < 1000) backoff *= 2;
+            }
+        }
+    }
+
+    bool EEProm24AA08::ReadBytes(uint16_t address, uint8_t* data, size_t length)
+    {
+        if (!completeWrite())
+        {
 #ifndef LOWLEVELCPPCLASSES_DISABLE_EXCEPTIONS
-                throw std::invalid_argument( "Data buffer was not filled by block as expected!" );
+            throw std::runtime_error("Write in progress did not complete!");
+#endif
+            return false;
+        }
+        if (address + length > MEMORY_SIZE)
+        {
+#ifndef LOWLEVELCPPCLASSES_DISABLE_EXCEPTIONS
+            throw std::invalid_argument("Received Bad Address Value! Addresses are between 0-1023");
 #endif
+            return false;
+        }
+
+        size_t offset = 0;
+        while (offset < length)
+        {
+            const uint16_t currentAddress = address + offset;
+            const uint8_t blockIndex = getBlockForVirtualAddress(currentAddress);
 
-            };
+            // Sequential read up to the end of the block
+            size_t blockLength = BLOCK_SIZE - (currentAddress % BLOCK_SIZE);
+            if (blockLength > length - offset) blockLength = length - offset;
 
-            // Copy directly to out buffer
-            for (int j = 0; j < currentBlockReadLength; j++)
+            if (!i2cAccess->I2C_Mem_Read(ReadBufferAddresses[blockIndex], currentAddress % BLOCK_SIZE, 1,
+                                         data + offset, blockLength))
             {
-                data[dataIndex++] = tempData[j];
+#ifndef LOWLEVELCPPCLASSES_DISABLE_EXCEPTIONS
+                throw std::invalid_argument( "Data buffer was not filled by block as expected!" );
+#endif
+                return false;
             }
+            offset += blockLength;
         }
-
+        return true;
     }
 }
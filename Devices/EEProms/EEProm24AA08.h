@@ -5,138 +5,34 @@
 #ifndef EEPROM24AA08_H
 #define EEPROM24AA08_H
 
-#include <cmath>
-#include <vector>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "../../Base/LLE_I2C.h"
 
-namespace LowLevelEmbedded::Devices::EEProm
-{
-    class BlockWriteBuffer
-    {
-    private:
-    public:
-        BlockWriteBuffer(uint8_t blockNumber)
-        {
-            BlockNumber = blockNumber;
-            BlockWriteAddress = 0b10100000 | (blockNumber * 2);
-        }
-        void AddData(uint8_t startingAddress, const std::vector<uint8_t>& data)
-        {
-            StartingDataAddress = startingAddress;
-            Data = data;
-            PageWriteBuffers.clear(); // Clear any existing pages
-
-            uint8_t currentAddress = startingAddress;
-            size_t dataIndex = 0;
-            size_t dataSize = data.size();
-
-            while (dataIndex < dataSize)
-            {
-                std::vector<uint8_t> currentPage;
-                currentPage.push_back(currentAddress); // Include the starting address for this page
-
-                size_t bytesInPage = 0;
-                while (bytesInPage < 16 && dataIndex < dataSize)
-                {
-                    currentPage.push_back(data[dataIndex]);
-                    dataIndex++;
-                    bytesInPage++;
-                }
-
-                PageWriteBuffers.push_back(currentPage);
-                currentAddress += bytesInPage; // Increment the address by the number of bytes written
-            }
-        }
-        void ClearData()
-        {
-            StartingDataAddress = 0;
-            Data.clear();
-        }
-        uint8_t StartingDataAddress;
-        std::vector<uint8_t> Data;
-        std::vector<std::vector<uint8_t>> PageWriteBuffers;
-        uint8_t BlockNumber;
-        uint8_t BlockWriteAddress;
+// Time a page write may take before it counts as failed (tWC is 5 ms)
+#ifndef EEPROM24AA08_WRITE_CYCLE_TIMEOUT_MS
+#define EEPROM24AA08_WRITE_CYCLE_TIMEOUT_MS 10
+#endif
 
-};
+// Ready polls per page write before it counts as failed, only used when Utility::millis is not set
+#ifndef EEPROM24AA08_ACK_POLL_ATTEMPTS
+#define EEPROM24AA08_ACK_POLL_ATTEMPTS 200
+#endif
 
-    class MainWriteBuffer
+namespace LowLevelEmbedded::Devices::EEProm
+{
+    enum class EEProm24AA08_WriteStatus
     {
-    private:
-        BlockWriteBuffer* Block0 = new BlockWriteBuffer(0);
-        BlockWriteBuffer* Block1 = new BlockWriteBuffer(1);
-        BlockWriteBuffer* Block2 = new BlockWriteBuffer(2);
-        BlockWriteBuffer* Block3 = new BlockWriteBuffer(3);
-    public:
-        void AddData(uint16_t startingAddress, const uint8_t* data, size_t length)
-        {
-            StartingDataAddress = startingAddress;
-
-            // Copy data to the object's Data vector
-            Data.assign(data, data + length);
-
-            // Check if block contains data
-            uint16_t dataStart = startingAddress;
-            uint16_t dataEnd = startingAddress + length;
-            for (auto block: Blocks)
-            {
-                uint16_t blockStart = block->BlockNumber * 256;
-                uint16_t blockEnd = blockStart + 256;
-                if (dataStart < blockEnd && blockStart < dataEnd)
-                {
-                    // Find the overlap range
-                    uint16_t overlapStart = std::max(dataStart, blockStart);
-                    uint16_t overlapEnd = std::min(dataEnd, blockEnd);
-
-                    // Calculate the overlap length
-                    uint16_t overlapLength = overlapEnd - overlapStart;
-
-                    // Indices in the data buffer corresponding to the overlap
-                    uint16_t dataIndexStart = overlapStart - dataStart;
-
-                    // Get pointers for the data range
-                    const uint8_t* dataRangeStart = data + dataIndexStart;
-                    const uint8_t* dataRangeEnd = dataRangeStart + overlapLength;
-
-                    // Copy data from data pointer to blockData vector
-                    std::vector<uint8_t> blockData(dataRangeStart, dataRangeEnd);
-
-                    // Adjust the starting address relative to the block
-                    uint16_t blockRelativeAddress = overlapStart - blockStart;
-
-                    // Call AddData on the block with the correct parameters
-                    block->AddData(blockRelativeAddress, blockData);
-                }
-            }
-        }
-
-        void Clear()
-        {
-            for (auto block: Blocks)
-            {
-                block->ClearData();
-            }
-            StartingDataAddress = 0;
-            Data.clear();
-        }
-        uint16_t StartingDataAddress;
-        std::vector<uint8_t> Data;
-        BlockWriteBuffer* Blocks[4]
-        {
-            Block0,
-            Block1,
-            Block2,
-            Block3
-        };
+        Done,   // no write pending, the last one completed
+        Busy,   // a write is in progress
+        Error   // a page write was not acknowledged or did not complete in time
     };
 
     class EEProm24AA08
     {
     private:
         LowLevelEmbedded::II2CAccess* i2cAccess;
-        std::vector<uint8_t> MainReadData[4];
         const uint8_t ReadBufferAddresses[4]
         {
            0b10100001 | 0x00,
@@ -144,39 +40,72 @@ namespace LowLevelEmbedded::Devices::EEProm
            0b10100001 | 0x04,
            0b10100001 | 0x06,
         };
-        /**
-         * @brief Address within each 256 byte block (0-255)
-         */
-        uint8_t blockAddressDataPointer;
-        /**
-         * @brief block address Index (0 - 3)
-         */
-        uint8_t currentBlockIndex;
         uint8_t getBlockForVirtualAddress(uint16_t virtualAddress);
-        void initWriteBuffers();
-        void initReadBuffers();
+
+        // State of the write in progress
+        uint8_t* writeData = nullptr;
+        uint16_t writeAddress = 0;
+        size_t writeLength = 0;
+        size_t writeOffset = 0;
+        uint8_t writeBlockIndex = 0;   // block of the page that is in its write cycle
+        uint32_t writeCycleStart = 0;  // Utility::millis when that page was sent
+        uint16_t writePolls = 0;
+        bool writing = false;
+
+        bool writeNextPage();
         /**
-         * @brief Polls the EEProm in order to figure out if the write operation is complete
+         * @brief Polls the EEProm, with a growing delay in between, until the write in progress is complete
          */
-        bool ackPolling(int8_t blockIndex);
+        bool completeWrite();
     public:
+        /// Bytes written with one page write, a page write must not cross a page boundary
+        static constexpr uint16_t PAGE_SIZE = 16;
+        /// Bytes behind one I2C address
+        static constexpr uint16_t BLOCK_SIZE = 256;
+        static constexpr uint16_t MEMORY_SIZE = 1024;
+
         EEProm24AA08(LowLevelEmbedded::II2CAccess* I2C_Access)
         {
             this->i2cAccess = I2C_Access;
-            this->WriteBuffer = new MainWriteBuffer();
         }
         /**
          * @brief Writes a byte array to the EEProm Chip. Maximum Address 1023.
          *
+         * The data is split on the 16 byte page boundaries (and so also on the 256 byte block boundaries) and every
+         * page is written straight from data, without buffering. Blocks until the last page is written, between
+         * the ready polls Utility::Delay_us is called with a delay that grows from 100 us to 1 ms.
+         *
+         * @returns false if a page write failed or did not complete within EEPROM24AA08_WRITE_CYCLE_TIMEOUT_MS
+         */
+        bool WriteBytes(uint16_t address, uint8_t* data, size_t length);
+        /**
+         * @brief Starts writing a byte array without waiting for the write cycles. Maximum Address 1023.
+         *
+         * Sends the first page, ContinueWrite sends the next page once the EEProm has finished the previous one.
+         * While the EEProm is busy the bus can be used for other devices. data must stay valid until the write
+         * is done.
+         *
+         * @returns false if a write is already in progress, the address is out of range or the first page failed
+         */
+        bool StartWriteBytes(uint16_t address, uint8_t* data, size_t length);
+        /**
+         * @brief Advances the write started by StartWriteBytes, call it periodically.
+         *
+         * Every call does one ready poll, and sends the next page when the EEProm is ready.
          */
-        void WriteBytes(uint16_t address, uint8_t* data, size_t length);
+        EEProm24AA08_WriteStatus ContinueWrite();
+        /// true between StartWriteBytes and the end of the write
+        bool IsWriting() const;
         /**
-         * @brief Reads a byte array to the EEProm Chip. Maximum Address 1023.
+         * @brief Reads a byte array from the EEProm Chip. Maximum Address 1023.
          *
-         * @returns The Byte at the memory location
+         * The bytes are read straight into data with one sequential read per 256 byte block, so the whole
+         * 1 KB takes four transfers.
+         * A write in progress is completed first, the EEProm does not answer during a write cycle.
          *
+         * @returns false if a read failed
          */
-        void ReadBytes(uint16_t address, uint8_t*& data, size_t length);
+        bool ReadBytes(uint16_t address, uint8_t* data, size_t length);
 
         const uint8_t USED_I2C_ADDRESSES[8]
         {
@@ -189,7 +118,6 @@ namespace LowLevelEmbedded::Devices::EEProm
             0b10101000 | 0x04,
             0b10101000 | 0x06
         };
-        MainWriteBuffer* WriteBuffer;
     };
 }
 
@@ -5,6 +5,7 @@
 #include "MAX31790.h"
 #include "../../Base/LLE_tools.h"
 #include <cmath>
+#include <cstring>
 
 namespace LowLevelEmbedded
 {
@@ -12,30 +13,150 @@ namespace LowLevelEmbedded
 	{
 		namespace FanControllers
 		{
+			namespace
+			{
+				inline bool testRegisterBit(const uint32_t* map, uint8_t reg)
+				{
+					return (map[reg >> 5] >> (reg & 31)) & 1;
+				}
+
+				inline void setRegisterBit(uint32_t* map, uint8_t reg)
+				{
+					map[reg >> 5] |= 1UL << (reg & 31);
+				}
+
+				inline void clearRegisterBit(uint32_t* map, uint8_t reg)
+				{
+					map[reg >> 5] &= ~(1UL << (reg & 31));
+				}
+			}
+
 			//Constructor
 			MAX31790::MAX31790(II2CAccess *i2cAccess, uint8_t slaveAddres)
 			{
 				_I2CAccess = i2cAccess;
 				_SlaveAddress = slaveAddres;
-				//read shadow registers from device
+				_Batching = false;
 				for (int i = 0; i < 6; ++i)
 				{
 					_NumberOfTachoPulsesPerRevolution[i] = 2;
+				}
+				memset(_Shadow, 0, sizeof(_Shadow));
+				memset(_ShadowValid, 0, sizeof(_ShadowValid));
+				memset(_ShadowDirty, 0, sizeof(_ShadowDirty));
+				//read shadow registers from device
+				ReloadShadow();
+			}
 
-					uint8_t tempBuffer = FAN1_CONFIGURATION_ADDRESS + i;
-					_I2CAccess->I2C_WriteMethod(_SlaveAddress, &tempBuffer, 1); //set address in device for next read
-					_I2CAccess->I2C_ReadMethod(_SlaveAddress, &_FanConfigurationRegisters[i], 1);
+			bool MAX31790::_isWritable(uint8_t reg) const
+			{
+				return (reg <= FAN6_DYNAMICS_ADDRESS) ||
+					((reg >= FAN_FAULT_MASK2_ADDRESS) && (reg <= FAILED_FAN_OPTIONS_ADDRESS)) ||
+					((reg >= PWMOUT1_TARGET_DUTYCYCLE_MSB_ADDRESS) && (reg <= PWMOUT6_TARGET_DUTYCYCLE_LSB_ADDRESS)) ||
+					((reg >= TACH1_TARGET_COUNT_MSB_ADDRESS) && (reg <= TACH6_TARGET_COUNT_LSB_ADDRESS)) ||
+					((reg >= WINDOW1_MSB_ADDRESS) && (reg <= WINDOW6_MSB_ADDRESS));
+			}
 
-					tempBuffer = FAN1_DYNAMICS_ADDRESS + i;
-					_I2CAccess->I2C_WriteMethod(_SlaveAddress, &tempBuffer, 1); //set address in device for next read
-					_I2CAccess->I2C_ReadMethod(_SlaveAddress, &_FanDynamicsRegisters[i], 1);
+			bool MAX31790::_readShadowBlock(uint8_t firstRegister, uint8_t lastRegister)
+			{
+				const uint8_t count = lastRegister - firstRegister + 1;
+				const bool result = _I2CAccess->I2C_Mem_Read(_SlaveAddress, firstRegister, 1, &_Shadow[firstRegister], count);
+				for (uint8_t reg = firstRegister; reg <= lastRegister; ++reg)
+				{
+					clearRegisterBit(_ShadowDirty, reg);
+					if (result) setRegisterBit(_ShadowValid, reg);
+					else clearRegisterBit(_ShadowValid, reg);
 				}
+				return result;
+			}
+
+			bool MAX31790::ReloadShadow()
+			{
+				//one burst read per block of writable registers
+				bool result = _readShadowBlock(GLOBAL_CONFIGURATION_ADDRESS, FAN6_DYNAMICS_ADDRESS);
+				result = _readShadowBlock(FAN_FAULT_MASK2_ADDRESS, FAILED_FAN_OPTIONS_ADDRESS) && result;
+				result = _readShadowBlock(PWMOUT1_TARGET_DUTYCYCLE_MSB_ADDRESS, PWMOUT6_TARGET_DUTYCYCLE_LSB_ADDRESS) && result;
+				result = _readShadowBlock(TACH1_TARGET_COUNT_MSB_ADDRESS, TACH6_TARGET_COUNT_LSB_ADDRESS) && result;
+				result = _readShadowBlock(WINDOW1_MSB_ADDRESS, WINDOW6_MSB_ADDRESS) && result;
+				return result;
 			}
 
 			bool MAX31790::_writeToRegister(uint8_t reg, uint8_t data)
 			{
-				uint8_t tempBuffer[2] = {reg, data};
-				return _I2CAccess->I2C_WriteMethod(_SlaveAddress, &tempBuffer[0], 2);
+				return _writeToRegisters(reg, &data, 1);
+			}
+
+			bool MAX31790::_writeToRegisters(uint8_t reg, const uint8_t* data, uint8_t count)
+			{
+				for (uint8_t i = 0; i < count; ++i)
+				{
+					const uint8_t address = reg + i;
+					//nothing to do when the device already has this value
+					if (testRegisterBit(_ShadowValid, address) && !testRegisterBit(_ShadowDirty, address) &&
+						(_Shadow[address] == data[i])) continue;
+					_Shadow[address] = data[i];
+					setRegisterBit(_ShadowDirty, address);
+				}
+				return _Batching ? true : Flush();
+			}
+
+			void MAX31790::BeginBatch()
+			{
+				_Batching = true;
+			}
+
+			bool MAX31790::EndBatch()
+			{
+				_Batching = false;
+				return Flush();
+			}
+
+			bool MAX31790::Flush()
+			{
+				bool result = true;
+				uint8_t reg = 0;
+				while (reg < SHADOW_SIZE)
+				{
+					if (!testRegisterBit(_ShadowDirty, reg))
+					{
+						++reg;
+						continue;
+					}
+
+					//extend the write over the following dirty registers, bridging short runs of known clean ones
+					uint8_t end = reg + 1;
+					uint8_t next = end;
+					while ((next < SHADOW_SIZE) && (next <= end + MAX_BRIDGED_REGISTERS))
+					{
+						if (testRegisterBit(_ShadowDirty, next))
+						{
+							end = ++next;
+						}
+						else if (_isWritable(next) && testRegisterBit(_ShadowValid, next))
+						{
+							++next;
+						}
+						else
+						{
+							break;
+						}
+					}
+
+					if (_I2CAccess->I2C_Mem_Write(_SlaveAddress, reg, 1, &_Shadow[reg], end - reg))
+					{
+						for (uint8_t written = reg; written < end; ++written)
+						{
+							clearRegisterBit(_ShadowDirty, written);
+							setRegisterBit(_ShadowValid, written);
+						}
+					}
+					else
+					{
+						result = false;
+					}
+					reg = end;
+				}
+				return result;
 			}
 
 			uint8_t MAX31790::_readFromRegister(uint8_t reg)
@@ -48,16 +169,17 @@ namespace LowLevelEmbedded
 
 			bool MAX31790::setFanMode(uint8_t fanID, MAX31790_FanMode fanmode)
 			{
+				uint8_t configuration = _Shadow[FAN1_CONFIGURATION_ADDRESS + fanID];
 				switch (fanmode)
 				{
 					case MAX31790_FanMode::PWMMode:
-						CLEAR_BIT(_FanConfigurationRegisters[fanID], FC_RPM_MODE_SHIFT);
+						CLEAR_BIT(configuration, 1 << FC_RPM_MODE_SHIFT);
 						break;
 					case MAX31790_FanMode::RPMMode:
-						SET_BIT(_FanConfigurationRegisters[fanID], FC_RPM_MODE_SHIFT);
+						SET_BIT(configuration, 1 << FC_RPM_MODE_SHIFT);
 						break;
 				}
-				return _writeToRegister(FAN1_CONFIGURATION_ADDRESS + fanID, _FanConfigurationRegisters[fanID]);
+				return _writeToRegister(FAN1_CONFIGURATION_ADDRESS + fanID, configuration);
 			}
 
 			void  MAX31790::setFanPulsesPerRevolution(uint8_t fanID, uint8_t numberOfPulsesPerRevolution)
@@ -68,15 +190,15 @@ namespace LowLevelEmbedded
 			bool MAX31790::setFanSpeedRange(uint8_t fanID, MAX31790_NumberOfTachPeriods numberOfTachPeriodsCounted)
 			{
 				uint8_t speedRange = static_cast<uint32_t>(numberOfTachPeriodsCounted);
-				_FanConfigurationRegisters[fanID] = (_FanConfigurationRegisters[fanID] & 0b00011111) | (speedRange << 5);
-				return _writeToRegister(FAN1_DYNAMICS_ADDRESS + fanID, _FanConfigurationRegisters[fanID]);
+				const uint8_t dynamics = (_Shadow[FAN1_DYNAMICS_ADDRESS + fanID] & 0b00011111) | (speedRange << FD_SPEED_RANGE_SHIFT);
+				return _writeToRegister(FAN1_DYNAMICS_ADDRESS + fanID, dynamics);
 			}
 
 			bool MAX31790::setFanRateOfChange(uint8_t fanID, MAX31790_RateOfChange rateOfChange)
 			{
 				uint8_t rot = static_cast<uint8_t>(rateOfChange);
-				_FanConfigurationRegisters[fanID] = (_FanConfigurationRegisters[fanID] & 0b11100011) | (rot << 2);
-				return _writeToRegister(FAN1_DYNAMICS_ADDRESS + fanID, _FanConfigurationRegisters[fanID]);
+				const uint8_t dynamics = (_Shadow[FAN1_DYNAMICS_ADDRESS + fanID] & 0b11100011) | (rot << FD_PWM_RATE_OF_CHANGE_SHIFT);
+				return _writeToRegister(FAN1_DYNAMICS_ADDRESS + fanID, dynamics);
 			}
 
 			bool MAX31790::setFanTargetSpeed(
@@ -88,20 +210,15 @@ namespace LowLevelEmbedded
 				if (rpm <= 0.0f)
 				{
 					constexpr uint16_t stoppedTargetCount = 2047;
-					const uint8_t lowerByte = static_cast<uint8_t>(stoppedTargetCount << 5);
-					const uint8_t higherByte = static_cast<uint8_t>(stoppedTargetCount >> 3);
-					if (!_writeToRegister(TACH1_TARGET_COUNT_MSB_ADDRESS + (fanID * 2), higherByte)) return false;
-					return _writeToRegister(TACH1_TARGET_COUNT_LSB_ADDRESS + (fanID * 2), lowerByte);
+					const uint8_t count[2] = {static_cast<uint8_t>(stoppedTargetCount >> 3), static_cast<uint8_t>(stoppedTargetCount << 5)};
+					return _writeToRegisters(TACH1_TARGET_COUNT_MSB_ADDRESS + (fanID * 2), count, 2);
 				}
 
 				float speedAsFloat = (60.0 / (_NumberOfTachoPulsesPerRevolution[fanID] * rpm)) * SR * 8192;
 				uint16_t speedAsInt = round(speedAsFloat);
 				if(speedAsInt > 2047) speedAsInt = 2047;
-				uint8_t lowerByte = (uint8_t) (speedAsInt << 5);
-				uint8_t higherByte = (uint8_t) (speedAsInt >> 3);
-				if(!_writeToRegister(TACH1_TARGET_COUNT_MSB_ADDRESS + (fanID * 2), higherByte)) return false;
-				if(!_writeToRegister(TACH1_TARGET_COUNT_LSB_ADDRESS + (fanID * 2), lowerByte)) return false;
-				return true;
+				const uint8_t count[2] = {(uint8_t) (speedAsInt >> 3), (uint8_t) (speedAsInt << 5)};
+				return _writeToRegisters(TACH1_TARGET_COUNT_MSB_ADDRESS + (fanID * 2), count, 2);
 			}
 
 			bool MAX31790::setFanTargetPWM(uint8_t fanID, unitsnet_cpp::Ratio pwm)
@@ -109,10 +226,8 @@ namespace LowLevelEmbedded
 				const auto dutyCycle = pwm.decimal_fractions();
 				if (dutyCycle < 0.0f || dutyCycle > 1.0f) return false;
 				uint16_t pwmAsInt = round(dutyCycle * 511);
-				uint8_t lowerByte = (uint8_t) (pwmAsInt << 7);
-				uint8_t higherByte = (uint8_t) (pwmAsInt >> 1);
-				if(!_writeToRegister(PWMOUT1_TARGET_DUTYCYCLE_MSB_ADDRESS + (fanID * 2), higherByte)) return false;
-				return _writeToRegister(PWMOUT1_TARGET_DUTYCYCLE_LSB_ADDRESS + (fanID * 2), lowerByte);
+				const uint8_t target[2] = {(uint8_t) (pwmAsInt >> 1), (uint8_t) (pwmAsInt << 7)};
+				return _writeToRegisters(PWMOUT1_TARGET_DUTYCYCLE_MSB_ADDRESS + (fanID * 2), target, 2);
 			}
 
 			bool MAX31790::setFanWindow(uint8_t fanID, uint8_t window)
@@ -123,7 +238,7 @@ namespace LowLevelEmbedded
 			uint16_t MAX31790::_getFanSpeedRange(uint8_t fanID) const
 			{
 				uint16_t SR;
-				switch ((MAX31790_NumberOfTachPeriods)(_FanConfigurationRegisters[fanID] >> 5))
+				switch ((MAX31790_NumberOfTachPeriods)(_Shadow[FAN1_DYNAMICS_ADDRESS + fanID] >> FD_SPEED_RANGE_SHIFT))
 				{
 					case MAX31790_NumberOfTachPeriods::one:
 						SR = 1;
@@ -149,20 +264,58 @@ namespace LowLevelEmbedded
 				return SR;
 			}
 
-			unitsnet_cpp::RotationalSpeed MAX31790::getFanSpeed(uint8_t fanID)
+			unitsnet_cpp::RotationalSpeed MAX31790::_tachCountToSpeed(uint8_t fanID, uint16_t tachCount) const
 			{
-				uint16_t SR = _getFanSpeedRange(fanID);
-				uint16_t TC_MSB = _readFromRegister(TACH1_COUNT_MSB_ADDRESS + (fanID * 2));
-				uint16_t TC_LSB = _readFromRegister(TACH1_COUNT_LSB_ADDRESS + (fanID * 2));
-				uint16_t TC = (TC_LSB >> 5) | (TC_MSB << 3);
-				if (TC == 0 || TC == 2047)
+				if (tachCount == 0 || tachCount == 2047)
 				{
 					return unitsnet_cpp::RotationalSpeed::from_revolutions_per_minute(0.0f);
 				}
-				float rpmAsFloat = (60 * SR * 8192) / (TC * _NumberOfTachoPulsesPerRevolution[fanID]);
+				uint16_t SR = _getFanSpeedRange(fanID);
+				float rpmAsFloat = (60.0f * SR * 8192) / (tachCount * _NumberOfTachoPulsesPerRevolution[fanID]);
 				return unitsnet_cpp::RotationalSpeed::from_revolutions_per_minute(rpmAsFloat);
 			}
 
+			unitsnet_cpp::RotationalSpeed MAX31790::getFanSpeed(uint8_t fanID)
+			{
+				uint8_t count[2] = {0, 0};
+				_I2CAccess->I2C_Mem_Read(_SlaveAddress, TACH1_COUNT_MSB_ADDRESS + (fanID * 2), 1, count, 2);
+				uint16_t TC = (count[1] >> TACH_COUNT_SHIFT) | (count[0] << 3);
+				return _tachCountToSpeed(fanID, TC);
+			}
+
+			bool MAX31790::ReadAllTachCounts(MAX31790_Telemetry& telemetry)
+			{
+				// Fault status 2 (0x10) up to TACH6 count LSB (0x23), the device increments the register address
+				constexpr uint8_t firstAddress = 0x10;
+				uint8_t block[0x24 - firstAddress];
+				if (!_I2CAccess->I2C_Mem_Read(_SlaveAddress, firstAddress, 1, block, sizeof(block))) return false;
+
+				telemetry.FanFaults = (block[FAN_FAULT_STATUS1_ADDRESS - firstAddress] & 0x3F) |
+					((block[FAN_FAULT_STATUS2_ADDRESS - firstAddress] & 0x3F) << 6);
+				for (uint8_t fanID = 0; fanID < 6; ++fanID)
+				{
+					const uint8_t msb = block[TACH1_COUNT_MSB_ADDRESS - firstAddress + (fanID * 2)];
+					const uint8_t lsb = block[TACH1_COUNT_LSB_ADDRESS - firstAddress + (fanID * 2)];
+					telemetry.TachCount[fanID] = (lsb >> TACH_COUNT_SHIFT) | (msb << 3);
+					telemetry.FanSpeed[fanID] = _tachCountToSpeed(fanID, telemetry.TachCount[fanID]);
+				}
+				return true;
+			}
+
+			uint16_t MAX31790::FanFaultMask() const
+			{
+				uint16_t mask = 0;
+				if (testRegisterBit(_ShadowValid, FAN_FAULT_MASK1_ADDRESS))
+				{
+					mask |= _Shadow[FAN_FAULT_MASK1_ADDRESS] & 0x3F;
+				}
+				if (testRegisterBit(_ShadowValid, FAN_FAULT_MASK2_ADDRESS))
+				{
+					mask |= (_Shadow[FAN_FAULT_MASK2_ADDRESS] & 0x3F) << 6;
+				}
+				return mask;
+			}
+
 		}
 	}
 }
@@ -22,6 +22,14 @@ namespace LowLevelEmbedded
 
 			enum class MAX31790_NumberOfTachPeriods{four = 0b010, one = 0b000, two = 0b001, eight = 0b011, sixteen = 0b100, thirtyTwo = 0b111 };
 
+			/// The result of MAX31790::ReadAllTachCounts
+			struct MAX31790_Telemetry
+			{
+				uint16_t TachCount[6];                     // raw 11-bit TACH counts of fans 1..6
+				unitsnet_cpp::RotationalSpeed FanSpeed[6]; // 0 rpm for a stopped fan (count 0 or 2047)
+				uint16_t FanFaults;                        // bit n set: fault on TACH input n+1 (1..12)
+			};
+
 			class MAX31790
 			{
 			 private:
@@ -150,13 +158,23 @@ namespace LowLevelEmbedded
 				uint8_t _SlaveAddress;
 				uint8_t _NumberOfTachoPulsesPerRevolution[6];
 
+				//a clean register in between two dirty ones is written again rather than starting a second write
+				static constexpr uint8_t MAX_BRIDGED_REGISTERS = 2;
+
 				bool _writeToRegister(uint8_t reg, uint8_t data);
+				bool _writeToRegisters(uint8_t reg, const uint8_t* data, uint8_t count);
 				uint8_t _readFromRegister(uint8_t reg);
+				bool _readShadowBlock(uint8_t firstRegister, uint8_t lastRegister);
+				bool _isWritable(uint8_t reg) const;
 				uint16_t _getFanSpeedRange(uint8_t fanID) const;
+				unitsnet_cpp::RotationalSpeed _tachCountToSpeed(uint8_t fanID, uint16_t tachCount) const;
 
-				//shadow registers
-				uint8_t _FanConfigurationRegisters[6];
-				uint8_t _FanDynamicsRegisters[6];
+				//shadow of the writable registers 0x00..0x65
+				static constexpr uint8_t SHADOW_SIZE = 0x66;
+				uint8_t _Shadow[SHADOW_SIZE];
+				uint32_t _ShadowValid[4]; //bit set: the shadow holds the value of the device
+				uint32_t _ShadowDirty[4]; //bit set: the shadow holds a value that still has to be written
+				bool _Batching;
 
 			 public:
 				/// The constructor of the Fan Controller
@@ -228,6 +246,34 @@ namespace LowLevelEmbedded
 				/// \param fanID the zero based fan ID (0..5)
 				/// \return The fan speed in rpm.
 				unitsnet_cpp::RotationalSpeed getFanSpeed(uint8_t fanID);
+
+				/// Reads the fault status and the TACH counts of all six fans in one burst read (0x10..0x23)
+				/// and converts the counts to speeds. Use this instead of six getFanSpeed calls when polling.
+				/// \param telemetry receives the counts, speeds and fault flags
+				/// \return true if no errors occurred.
+				bool ReadAllTachCounts(MAX31790_Telemetry& telemetry);
+
+				/// The fan fault mask registers (0x12, 0x13) from the shadow, in the bit layout of
+				/// MAX31790_Telemetry::FanFaults. A set bit means faults on that TACH input do not count.
+				/// \return 0 for a register the shadow could not read
+				uint16_t FanFaultMask() const;
+
+				/// Reads all writable registers back into the shadow, e.g. after the device was reset.
+				/// Pending writes are discarded.
+				/// \return true if no errors occurred.
+				bool ReloadShadow();
+
+				/// Collects the register writes of the following calls in the shadow instead of writing them immediately.
+				void BeginBatch();
+
+				/// Writes the registers that changed, adjacent registers in one multi-byte write. The batch stays open.
+				/// Registers that fail to write are retried on the next flush.
+				/// \return true if no errors occurred.
+				bool Flush();
+
+				/// Writes the registers that changed and returns to writing every change immediately.
+				/// \return true if no errors occurred.
+				bool EndBatch();
 			};
 		}
 	}
@@ -0,0 +1,297 @@
+#include "MAX31790ThermalControl.h"
+#include "../../Utilities/LL_Math.h"
+
+#include <cmath>
+#include <ulog.h>
+
+namespace LowLevelEmbedded::Devices::FanControllers
+{
+    MAX31790ThermalControl::MAX31790ThermalControl(MAX31790* fanController)
+    {
+        this->_fans = fanController;
+    }
+
+    int32_t MAX31790ThermalControl::_toMilliCelsius(unitsnet_cpp::Temperature temperature)
+    {
+        return roundToInt32Clamped(temperature.degrees_celsius() * 1000.0f);
+    }
+
+    bool MAX31790ThermalControl::_configure(const uint8_t fanID, ITemperatureSensor* sensor,
+                                            const MAX31790_FanMode fanMode)
+    {
+        if ((fanID >= CHANNEL_COUNT) || (sensor == nullptr))
+        {
+            return false;
+        }
+        if (!this->_fans->setFanMode(fanID, fanMode))
+        {
+            return false;
+        }
+
+        Channel& channel = this->_channels[fanID];
+        const int32_t failsafe = channel.Failsafe;
+        channel = Channel();
+        channel.Failsafe = failsafe;
+        channel.FanMode = fanMode;
+        channel.Sensor = sensor;
+        channel.Maximum = (fanMode == MAX31790_FanMode::PWMMode) ? 1000 : 10000;
+        return true;
+    }
+
+    bool MAX31790ThermalControl::ConfigureCurve(const uint8_t fanID, ITemperatureSensor* sensor,
+                                                const MAX31790FanCurve* curve, const MAX31790_FanMode fanMode)
+    {
+        if ((curve == nullptr) || !_configure(fanID, sensor, fanMode))
+        {
+            return false;
+        }
+        this->_channels[fanID].Curve = curve;
+        this->_channels[fanID].Control = MAX31790_ControlMode::Curve;
+        return true;
+    }
+
+    bool MAX31790ThermalControl::ConfigurePID(const uint8_t fanID, ITemperatureSensor* sensor,
+                                              unitsnet_cpp::Temperature setpoint, const MAX31790_PIDGains& gains,
+                                              const MAX31790_FanMode fanMode)
+    {
+        if (!_configure(fanID, sensor, fanMode))
+        {
+            return false;
+        }
+        this->_channels[fanID].Gains = gains;
+        this->_channels[fanID].Setpoint = _toMilliCelsius(setpoint);
+        this->_channels[fanID].Control = MAX31790_ControlMode::PID;
+        return true;
+    }
+
+    void MAX31790ThermalControl::Disable(const uint8_t fanID)
+    {
+        if (fanID >= CHANNEL_COUNT) return;
+        this->_channels[fanID].Control = MAX31790_ControlMode::Off;
+    }
+
+    void MAX31790ThermalControl::SetSetpoint(const uint8_t fanID, unitsnet_cpp::Temperature setpoint)
+    {
+        if (fanID >= CHANNEL_COUNT) return;
+        this->_channels[fanID].Setpoint = _toMilliCelsius(setpoint);
+    }
+
+    bool MAX31790ThermalControl::SetOutputLimits(const uint8_t fanID, const int32_t minimum, const int32_t maximum)
+    {
+        if ((fanID >= CHANNEL_COUNT) || (minimum > maximum) || (minimum < 0))
+        {
+            return false;
+        }
+        this->_channels[fanID].Minimum = minimum;
+        this->_channels[fanID].Maximum = maximum;
+        return true;
+    }
+
+    bool MAX31790ThermalControl::SetFailsafeDutyCycle(const uint8_t fanID, unitsnet_cpp::Ratio dutyCycle)
+    {
+        const float fraction = dutyCycle.decimal_fractions();
+        if ((fanID >= CHANNEL_COUNT) || (fraction < 0.0f) || (fraction > 1.0f))
+        {
+            return false;
+        }
+        this->_channels[fanID].Failsafe = roundToInt32Clamped(fraction * 1000.0f);
+        // Rewrite on the next PeriodicJob if the failsafe is running
+        this->_channels[fanID].WrittenValid = false;
+        return true;
+    }
+
+    void MAX31790ThermalControl::SetSensorLimits(unitsnet_cpp::Temperature minimum, unitsnet_cpp::Temperature maximum)
+    {
+        this->_sensorMinimum = _toMilliCelsius(minimum);
+        this->_sensorMaximum = _toMilliCelsius(maximum);
+    }
+
+    int32_t MAX31790ThermalControl::Output(const uint8_t fanID) const
+    {
+        return (fanID < CHANNEL_COUNT) ? this->_channels[fanID].Output : 0;
+    }
+
+    int32_t MAX31790ThermalControl::Temperature(const uint8_t fanID) const
+    {
+        return (fanID < CHANNEL_COUNT) ? this->_channels[fanID].Temperature : 0;
+    }
+
+    uint8_t MAX31790ThermalControl::Faults(const uint8_t fanID) const
+    {
+        return (fanID < CHANNEL_COUNT) ? this->_channels[fanID].Faults : static_cast<uint8_t>(tfNone);
+    }
+
+    const MAX31790_Telemetry& MAX31790ThermalControl::Telemetry() const
+    {
+        return this->_telemetry;
+    }
+
+    void MAX31790ThermalControl::PeriodicJob(unitsnet_cpp::Duration elapsedTime)
+    {
+        const int32_t elapsedMilliseconds = roundToInt32Clamped(elapsedTime.milliseconds(), 1, INT32_MAX);
+
+        // Read every sensor once, several channels can follow the same one
+        ITemperatureSensor* sensors[CHANNEL_COUNT];
+        int32_t readings[CHANNEL_COUNT];
+        bool readingValid[CHANNEL_COUNT];
+        uint8_t sensorCount = 0;
+        uint8_t sensorFaults[CHANNEL_COUNT] = {};
+        for (uint8_t fanID = 0; fanID < CHANNEL_COUNT; fanID++)
+        {
+            Channel& channel = this->_channels[fanID];
+            if (channel.Control == MAX31790_ControlMode::Off) continue;
+
+            uint8_t sensor = 0;
+            while ((sensor < sensorCount) && (sensors[sensor] != channel.Sensor)) sensor++;
+            if (sensor == sensorCount)
+            {
+                const float celsius = channel.Sensor->GetTemperature().degrees_celsius();
+                readings[sensor] = std::isfinite(celsius) ? roundToInt32Clamped(celsius * 1000.0f) : INT32_MIN;
+                readingValid[sensor] = (readings[sensor] >= this->_sensorMinimum) &&
+                    (readings[sensor] <= this->_sensorMaximum);
+                sensors[sensor] = channel.Sensor;
+                sensorCount++;
+            }
+            if (readingValid[sensor])
+            {
+                channel.Temperature = readings[sensor];
+            }
+            else
+            {
+                sensorFaults[fanID] = tfSensor;
+            }
+        }
+        if (sensorCount == 0)
+        {
+            return;
+        }
+
+        // The fault status of all fans in the same burst read as the TACH counts, the status bits are set
+        // regardless of the fault mask registers
+        uint8_t fanFaults = tfNone;
+        if (!this->_fans->ReadAllTachCounts(this->_telemetry))
+        {
+            fanFaults = tfBus;
+        }
+        else if ((this->_telemetry.FanFaults & ~this->_fans->FanFaultMask()) != 0)
+        {
+            fanFaults = tfFan;
+        }
+
+        for (uint8_t fanID = 0; fanID < CHANNEL_COUNT; fanID++)
+        {
+            Channel& channel = this->_channels[fanID];
+            if (channel.Control == MAX31790_ControlMode::Off) continue;
+
+            const uint8_t faults = sensorFaults[fanID] | fanFaults;
+            if (faults != channel.Faults)
+            {
+                if (faults != tfNone) log_warn("MAX31790: Fan %d running failsafe, faults 0x%02X", fanID + 1, faults);
+                else log_info("MAX31790: Fan %d back under thermal control", fanID + 1);
+                channel.Faults = faults;
+                if (this->FaultCallback) // check if callback was assigned
+                {
+                    this->FaultCallback(*this, fanID, faults);
+                }
+            }
+
+            if (channel.Faults == tfNone)
+            {
+                _calculate(channel, elapsedMilliseconds);
+            }
+            else
+            {
+                // Start over when the fault clears, the old state says nothing about the failsafe period
+                channel.Integral = 0;
+                channel.Primed = false;
+            }
+        }
+
+        // Targets last, adjacent registers go out in one write; a failed write stays pending in the shadow of
+        // the MAX31790 and is retried by the next EndBatch
+        this->_fans->BeginBatch();
+        for (uint8_t fanID = 0; fanID < CHANNEL_COUNT; fanID++)
+        {
+            if (this->_channels[fanID].Control == MAX31790_ControlMode::Off) continue;
+            _write(fanID, this->_channels[fanID]);
+        }
+        if (!this->_fans->EndBatch())
+        {
+            log_warn("MAX31790: Writing the fan targets failed");
+        }
+    }
+
+    void MAX31790ThermalControl::_calculate(Channel& channel, const int32_t elapsedMilliseconds)
+    {
+        int64_t output;
+        if (channel.Control == MAX31790_ControlMode::Curve)
+        {
+            output = channel.Curve->LookupY(channel.Temperature);
+        }
+        else
+        {
+            // error in mK, gains scaled by GAIN_SCALE, time in ms
+            constexpr int64_t proportionalScale = static_cast<int64_t>(GAIN_SCALE) * 1000;
+            constexpr int64_t integralScale = proportionalScale * 1000;
+            const int32_t error = channel.Temperature - channel.Setpoint;
+
+            channel.Integral += static_cast<int64_t>(channel.Gains.Ki) * error * elapsedMilliseconds;
+            // Anti-windup: the integral term alone never leaves the output range
+            const int64_t integralMinimum = channel.Minimum * integralScale;
+            const int64_t integralMaximum = channel.Maximum * integralScale;
+            if (channel.Integral < integralMinimum) channel.Integral = integralMinimum;
+            if (channel.Integral > integralMaximum) channel.Integral = integralMaximum;
+
+            output = static_cast<int64_t>(channel.Gains.Kp) * error / proportionalScale +
+                channel.Integral / integralScale;
+            if (channel.Primed)
+            {
+                // On the measurement, so a setpoint change does not kick the output
+                output += static_cast<int64_t>(channel.Gains.Kd) * (channel.Temperature - channel.LastTemperature) /
+                    (static_cast<int64_t>(GAIN_SCALE) * elapsedMilliseconds);
+            }
+            channel.LastTemperature = channel.Temperature;
+            channel.Primed = true;
+        }
+
+        if (output < channel.Minimum) output = channel.Minimum;
+        if (output > channel.Maximum) output = channel.Maximum;
+        channel.Output = static_cast<int32_t>(output);
+    }
+
+    void MAX31790ThermalControl::_write(const uint8_t fanID, Channel& channel)
+    {
+        const bool failsafe = channel.Faults != tfNone;
+        if (failsafe != channel.FailsafeActive)
+        {
+            // The failsafe is a duty cycle, an RPM channel is switched to PWM mode for it
+            if ((channel.FanMode == MAX31790_FanMode::RPMMode) &&
+                !this->_fans->setFanMode(fanID, failsafe ? MAX31790_FanMode::PWMMode : MAX31790_FanMode::RPMMode))
+            {
+                return; // try again on the next PeriodicJob
+            }
+            channel.FailsafeActive = failsafe;
+            channel.WrittenValid = false;
+        }
+
+        const int32_t value = failsafe ? channel.Failsafe : channel.Output;
+        if (channel.WrittenValid && (value == channel.Written))
+        {
+            return;
+        }
+
+        bool written;
+        if (failsafe || (channel.FanMode == MAX31790_FanMode::PWMMode))
+        {
+            written = this->_fans->setFanTargetPWM(
+                fanID, unitsnet_cpp::Ratio::from_decimal_fractions(static_cast<float>(value) / 1000.0f));
+        }
+        else
+        {
+            written = this->_fans->setFanTargetSpeed(
+                fanID, unitsnet_cpp::RotationalSpeed::from_revolutions_per_minute(static_cast<float>(value)));
+        }
+        channel.Written = value;
+        channel.WrittenValid = written;
+    }
+} // namespace LowLevelEmbedded::Devices::FanControllers
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "MAX31790.h"
+#include "../../Base/LLE_Temp.h"
+#include "../../Utilities/LookupTable.h"
+#include <Duration.hpp>
+#include <Ratio.hpp>
+#include <Temperature.hpp>
+#include <functional>
+
+// Number of points of a fan curve
+#ifndef MAX31790_FAN_CURVE_POINTS
+#define MAX31790_FAN_CURVE_POINTS 8
+#endif
+
+namespace LowLevelEmbedded::Devices::FanControllers
+{
+    /**
+     * Fan curve from temperature in millidegrees Celsius to the channel output (per mille duty cycle in PWM mode,
+     * rpm in RPM mode). Build it with allowExtrapolation = true, so temperatures outside the curve give the first
+     * or last output instead of an exception.
+     */
+    using MAX31790FanCurve = Utility::LookupTable<int32_t, int32_t, MAX31790_FAN_CURVE_POINTS>;
+
+    enum class MAX31790_ControlMode { Off, Curve, PID };
+
+    /// PID gains, all scaled by MAX31790ThermalControl::GAIN_SCALE
+    struct MAX31790_PIDGains
+    {
+        int32_t Kp; // output units per kelvin above the setpoint
+        int32_t Ki; // output units per kelvin second
+        int32_t Kd; // output units per kelvin per second of temperature rise
+    };
+
+    /// Fault flags of a channel, a channel with any flag set runs at its failsafe duty cycle
+    enum MAX31790_ThermalFault : uint8_t
+    {
+        tfNone = 0x0,
+        tfSensor = 0x1, // the sensor returned no number or a temperature outside the sensor limits
+        tfFan = 0x2,    // one of the fans reports an unmasked fault, the remaining fans have to take over
+        tfBus = 0x4     // the fault status of the MAX31790 could not be read
+    };
+
+    /**
+     * @class MAX31790ThermalControl
+     * @brief Closed-loop fan control: drives the MAX31790 fan channels from temperature sensors.
+     *
+     * Every channel follows one ITemperatureSensor, either through a fan curve or a PID loop. All arithmetic is
+     * done in fixed point on millidegrees Celsius and per mille duty cycle (or rpm).
+     *
+     * PeriodicJob works in three passes: it reads every sensor once (channels can share a sensor) and the fault
+     * status of all fans in one burst read, then calculates all outputs, and only then writes the targets that
+     * changed since the last write, batched in the register shadow of the MAX31790. When the sensor of a channel
+     * fails, or when any fan reports a fault, the channel is switched to PWM mode at its failsafe duty cycle until
+     * the fault clears.
+     */
+    class MAX31790ThermalControl
+    {
+    public:
+        static constexpr uint8_t CHANNEL_COUNT = 6;
+        static constexpr int32_t GAIN_SCALE = 1000;
+
+        explicit MAX31790ThermalControl(MAX31790* fanController);
+
+        /**
+         * Controls a fan channel with a fan curve.
+         *
+         * @param fanID the zero based fan ID (0..5)
+         * @param sensor the temperature that drives the fan
+         * @param curve the output for a temperature, must outlive the controller
+         * @param fanMode the unit of the curve output: per mille duty cycle or rpm
+         * @return false if an argument is invalid or the fan mode could not be written
+         */
+        bool ConfigureCurve(uint8_t fanID, ITemperatureSensor* sensor, const MAX31790FanCurve* curve,
+                            MAX31790_FanMode fanMode);
+
+        /**
+         * Controls a fan channel with a PID loop that keeps the sensor at the setpoint.
+         *
+         * @param fanID the zero based fan ID (0..5)
+         * @param sensor the temperature that drives the fan
+         * @param setpoint the temperature the loop regulates to
+         * @param gains the PID gains, the output is per mille duty cycle or rpm depending on fanMode
+         * @param fanMode PWM or RPM mode
+         * @return false if an argument is invalid or the fan mode could not be written
+         */
+        bool ConfigurePID(uint8_t fanID, ITemperatureSensor* sensor, unitsnet_cpp::Temperature setpoint,
+                          const MAX31790_PIDGains& gains, MAX31790_FanMode fanMode);
+
+        /// Stops controlling a channel, the fan keeps its last target.
+        void Disable(uint8_t fanID);
+
+        void SetSetpoint(uint8_t fanID, unitsnet_cpp::Temperature setpoint);
+
+        /**
+         * Limits the output of a channel. The defaults are 0..1000 in PWM mode and 0..10000 rpm in RPM mode.
+         * \return false if minimum is larger than maximum
+         */
+        bool SetOutputLimits(uint8_t fanID, int32_t minimum, int32_t maximum);
+
+        /// The duty cycle of a channel with a fault, 100% by default.
+        bool SetFailsafeDutyCycle(uint8_t fanID, unitsnet_cpp::Ratio dutyCycle);
+
+        /// Readings outside this range are treated as a sensor fault, -40..150 degrees Celsius by default.
+        void SetSensorLimits(unitsnet_cpp::Temperature minimum, unitsnet_cpp::Temperature maximum);
+
+        /// Reads the sensors, updates the control loops and writes the changed targets.
+        void PeriodicJob(unitsnet_cpp::Duration elapsedTime);
+
+        /// The last calculated output of a channel, per mille duty cycle or rpm.
+        int32_t Output(uint8_t fanID) const;
+
+        /// The last valid temperature of a channel in millidegrees Celsius.
+        int32_t Temperature(uint8_t fanID) const;
+
+        /// The MAX31790_ThermalFault flags of a channel.
+        uint8_t Faults(uint8_t fanID) const;
+
+        /// The telemetry of the last PeriodicJob.
+        const MAX31790_Telemetry& Telemetry() const;
+
+        /// Called from PeriodicJob when the fault flags of a channel change.
+        std::function<void(MAX31790ThermalControl&, uint8_t fanID, uint8_t faults)> FaultCallback;
+
+    private:
+        struct Channel
+        {
+            MAX31790_ControlMode Control = MAX31790_ControlMode::Off;
+            MAX31790_FanMode FanMode = MAX31790_FanMode::PWMMode;
+            ITemperatureSensor* Sensor = nullptr;
+            const MAX31790FanCurve* Curve = nullptr;
+            MAX31790_PIDGains Gains = {};
+            int32_t Setpoint = 0;       // millidegrees Celsius
+            int32_t Minimum = 0;
+            int32_t Maximum = 1000;
+            int32_t Failsafe = 1000;    // per mille duty cycle
+            int64_t Integral = 0;       // Ki * error * ms
+            int32_t Temperature = 0;    // millidegrees Celsius
+            int32_t LastTemperature = 0;
+            bool Primed = false;        // LastTemperature is valid
+            int32_t Output = 0;
+            int32_t Written = 0;        // the value of the last successful target write
+            bool WrittenValid = false;
+            bool FailsafeActive = false; // the fan was switched to PWM mode for the failsafe duty cycle
+            uint8_t Faults = tfNone;
+        };
+
+        MAX31790* _fans;
+        Channel _channels[CHANNEL_COUNT];
+        MAX31790_Telemetry _telemetry = {};
+        int32_t _sensorMinimum = -40000;
+        int32_t _sensorMaximum = 150000;
+
+        bool _configure(uint8_t fanID, ITemperatureSensor* sensor, MAX31790_FanMode fanMode);
+        void _calculate(Channel& channel, int32_t elapsedMilliseconds);
+        void _write(uint8_t fanID, Channel& channel);
+        static int32_t _toMilliCelsius(unitsnet_cpp::Temperature temperature);
+    };
+} // namespace LowLevelEmbedded::Devices::FanControllers
@@ -93,6 +93,17 @@ namespace LowLevelEmbedded::Devices::Monitoring
         return true;
     }
 
+    bool INA228::readRegister(uint8_t reg, uint8_t* data, size_t length)
+    {
+        // Pointer write and data read in one transaction (repeated start)
+        if (!_i2CAccess->I2C_Mem_Read(_slaveAddress, reg, 1, data, length))
+        {
+            return false;
+        }
+        _registerPointer = reg;
+        return true;
+    }
+
     void INA228::setRegisterPointerOnRead(uint8_t reg)
     {
         // Registry pointer is the same? If not, we don't need to do anything
@@ -192,7 +203,7 @@ namespace LowLevelEmbedded::Devices::Monitoring
         diagConfig ^= (-static_cast<uint16_t>(_config.ConversionReadyAssert) ^ diagConfig) & (1u << 14);
         diagConfig ^= (-static_cast<uint16_t>(_config.SlowAlert) ^ diagConfig) & (1u << 13);
         diagConfig ^= (-static_cast<uint16_t>(_config.AlertPolarity) ^ diagConfig) & (1u << 12);
-        if (!write16bitWord(CONFIG, diagConfig))
+        if (!write16bitWord(DIAG_ALRT, diagConfig))
         {
             return false;
         }
@@ -209,12 +220,8 @@ namespace LowLevelEmbedded::Devices::Monitoring
         return write16bitWord(SHUNT_TEMPCO, coefficient);
     }
 
-    unitsnet_cpp::ElectricPotential INA228::ReadShuntVoltage()
+    unitsnet_cpp::ElectricPotential INA228::decodeShuntVoltage(uint32_t reg24) const
     {
-        uint32_t reg24 = 0;
-        if (!read24bitWord(VSHUNT, reg24))
-            return unitsnet_cpp::ElectricPotential::from_volts(0.0f);
-
         // Sign-extend from 24-bit two's complement
         if (reg24 & 0x800000)          // bit 23 = sign
             reg24 |= 0xFF000000;       // extend to 32 bits
@@ -229,12 +236,8 @@ namespace LowLevelEmbedded::Devices::Monitoring
             static_cast<float>(vshuntRaw) * vshuntLSB);
     }
 
-    unitsnet_cpp::ElectricPotential INA228::ReadBusVoltage()
+    unitsnet_cpp::ElectricPotential INA228::decodeBusVoltage(uint32_t reg24)
     {
-        uint32_t reg24 = 0;
-        if (!read24bitWord(VBUS, reg24))
-            return unitsnet_cpp::ElectricPotential::from_volts(0.0f);
-
         // Sign-extend from 24-bit two's complement
         if (reg24 & 0x800000)          // bit 23 = sign
             reg24 |= 0xFF000000;       // extend to 32 bits
@@ -247,23 +250,17 @@ namespace LowLevelEmbedded::Devices::Monitoring
         return unitsnet_cpp::ElectricPotential::from_volts(vbusRaw * vbusLSB);
     }
 
-    unitsnet_cpp::Temperature INA228::ReadTemperature()
+    unitsnet_cpp::Temperature INA228::decodeTemperature(uint16_t reg16)
     {
-        int16_t tempRaw = 0;
-        if (!read16bitWord(DIETEMP, reinterpret_cast<uint16_t&>(tempRaw)))
-            return unitsnet_cpp::Temperature::from_degrees_celsius(0.0f);
+        const auto tempRaw = static_cast<int16_t>(reg16);
 
         // Temperature LSB = 7.8125 m°C/bit per datasheet
         constexpr float tempLSB = 7.8125e-3f;
         return unitsnet_cpp::Temperature::from_degrees_celsius(tempRaw * tempLSB);
     }
 
-    unitsnet_cpp::ElectricCurrent INA228::ReadCurrent()
+    unitsnet_cpp::ElectricCurrent INA228::decodeCurrent(uint32_t reg24) const
     {
-        uint32_t reg24 = 0;
-        if (!read24bitWord(CURRENT, reg24))
-            return unitsnet_cpp::ElectricCurrent::from_amperes(0.0f);
-
         // Sign-extend from 24-bit two's complement
         if (reg24 & 0x800000)          // bit 23 = sign
             reg24 |= 0xFF000000;       // extend to 32 bits
@@ -275,40 +272,155 @@ namespace LowLevelEmbedded::Devices::Monitoring
             static_cast<float>(currentRaw) * _currentLSB.amperes());
     }
 
+    unitsnet_cpp::Power INA228::decodePower(uint32_t reg24) const
+    {
+        return unitsnet_cpp::Power::from_watts(
+            reg24 * _currentLSB.amperes() * 3.2f);
+    }
+
+    unitsnet_cpp::Energy INA228::decodeEnergy(uint64_t reg40) const
+    {
+        return unitsnet_cpp::Energy::from_joules(
+            reg40 * _currentLSB.amperes() * 3.2f * 16.0f);
+    }
+
+    unitsnet_cpp::ElectricCharge INA228::decodeCharge(uint64_t reg40) const
+    {
+        auto chargeRaw = static_cast<int64_t>(reg40);
+
+        // Handle sign extension for 40-bit two's complement
+        if (chargeRaw & 0x8000000000)
+        {
+            chargeRaw |= 0xFFFFFF0000000000;
+        }
+
+        return unitsnet_cpp::ElectricCharge::from_coulombs(
+            chargeRaw * _currentLSB.amperes());
+    }
+
+    unitsnet_cpp::ElectricPotential INA228::ReadShuntVoltage()
+    {
+        uint32_t reg24 = 0;
+        if (!read24bitWord(VSHUNT, reg24))
+            return unitsnet_cpp::ElectricPotential::from_volts(0.0f);
+
+        return decodeShuntVoltage(reg24);
+    }
+
+    unitsnet_cpp::ElectricPotential INA228::ReadBusVoltage()
+    {
+        uint32_t reg24 = 0;
+        if (!read24bitWord(VBUS, reg24))
+            return unitsnet_cpp::ElectricPotential::from_volts(0.0f);
+
+        return decodeBusVoltage(reg24);
+    }
+
+    unitsnet_cpp::Temperature INA228::ReadTemperature()
+    {
+        uint16_t reg16 = 0;
+        if (!read16bitWord(DIETEMP, reg16))
+            return unitsnet_cpp::Temperature::from_degrees_celsius(0.0f);
+
+        return decodeTemperature(reg16);
+    }
+
+    unitsnet_cpp::ElectricCurrent INA228::ReadCurrent()
+    {
+        uint32_t reg24 = 0;
+        if (!read24bitWord(CURRENT, reg24))
+            return unitsnet_cpp::ElectricCurrent::from_amperes(0.0f);
+
+        return decodeCurrent(reg24);
+    }
+
     unitsnet_cpp::Power INA228::ReadPower()
     {
-        uint32_t powerRaw = 0;
-        if (!read24bitWord(POWER, powerRaw))
+        uint32_t reg24 = 0;
+        if (!read24bitWord(POWER, reg24))
             return unitsnet_cpp::Power::from_watts(0.0f);
 
-        return unitsnet_cpp::Power::from_watts(
-            powerRaw * _currentLSB.amperes() * 3.2f);
+        return decodePower(reg24);
     }
 
     unitsnet_cpp::Energy INA228::ReadEnergy()
     {
-        uint64_t energyRaw = 0;
-        if (!read40bitWord(ENERGY, energyRaw))
+        uint64_t reg40 = 0;
+        if (!read40bitWord(ENERGY, reg40))
             return unitsnet_cpp::Energy::from_joules(0.0f);
 
-        return unitsnet_cpp::Energy::from_joules(
-            energyRaw * _currentLSB.amperes() * 3.2f * 16.0f);
+        return decodeEnergy(reg40);
     }
 
     unitsnet_cpp::ElectricCharge INA228::ReadCharge()
     {
-        int64_t chargeRaw = 0;
-        if (!read40bitWord(CHARGE, reinterpret_cast<uint64_t&>(chargeRaw)))
+        uint64_t reg40 = 0;
+        if (!read40bitWord(CHARGE, reg40))
             return unitsnet_cpp::ElectricCharge::from_coulombs(0.0f);
 
-        // Handle sign extension for 40-bit two's complement
-        if (chargeRaw & 0x8000000000)
+        return decodeCharge(reg40);
+    }
+
+    bool INA228::ReadAccumulatorRegisters(uint64_t& energy, uint64_t& charge)
+    {
+        return read40bitWord(ENERGY, energy) && read40bitWord(CHARGE, charge);
+    }
+
+    unitsnet_cpp::ElectricCurrent INA228::CurrentLSB() const
+    {
+        return _currentLSB;
+    }
+
+    bool INA228::ReadSnapshot(INA228_Snapshot& snapshot, bool includeAccumulators)
+    {
+        // Raw register contents, decoded only after all bus traffic is done
+        uint8_t vshunt[3];
+        uint8_t vbus[3];
+        uint8_t dietemp[2];
+        uint8_t current[3];
+        uint8_t power[3];
+        uint8_t energy[5] = { 0 };
+        uint8_t charge[5] = { 0 };
+
+        if (!readRegister(VSHUNT, vshunt, sizeof(vshunt)) ||
+            !readRegister(VBUS, vbus, sizeof(vbus)) ||
+            !readRegister(DIETEMP, dietemp, sizeof(dietemp)) ||
+            !readRegister(CURRENT, current, sizeof(current)) ||
+            !readRegister(POWER, power, sizeof(power)))
         {
-            chargeRaw |= 0xFFFFFF0000000000;
+            return false;
         }
 
-        return unitsnet_cpp::ElectricCharge::from_coulombs(
-            chargeRaw * _currentLSB.amperes());
+        if (includeAccumulators)
+        {
+            if (!readRegister(ENERGY, energy, sizeof(energy)) ||
+                !readRegister(CHARGE, charge, sizeof(charge)))
+            {
+                return false;
+            }
+        }
+
+        auto be24 = [](const uint8_t* d)
+        {
+            return (static_cast<uint32_t>(d[0]) << 16) | (static_cast<uint32_t>(d[1]) << 8) | d[2];
+        };
+        auto be40 = [](const uint8_t* d)
+        {
+            return (static_cast<uint64_t>(d[0]) << 32) | (static_cast<uint64_t>(d[1]) << 24) |
+                   (static_cast<uint64_t>(d[2]) << 16) | (static_cast<uint64_t>(d[3]) << 8) | d[4];
+        };
+
+        snapshot.ShuntVoltage = decodeShuntVoltage(be24(vshunt));
+        snapshot.BusVoltage = decodeBusVoltage(be24(vbus));
+        snapshot.DieTemperature = decodeTemperature((static_cast<uint16_t>(dietemp[0]) << 8) | dietemp[1]);
+        snapshot.Current = decodeCurrent(be24(current));
+        snapshot.Power = decodePower(be24(power));
+        if (includeAccumulators)
+        {
+            snapshot.Energy = decodeEnergy(be40(energy));
+            snapshot.Charge = decodeCharge(be40(charge));
+        }
+        return true;
     }
 
     bool INA228::SetShuntVoltageOverLimit(unitsnet_cpp::ElectricPotential limit)
@@ -475,8 +587,14 @@ namespace LowLevelEmbedded::Devices::Monitoring
             return false;
         }
 
-        alert_status
-        =
+        alert_status = decodeAlertStatus(alertStatus);
+
+        return true;
+    }
+
+    INA228_DiagAlertStatus INA228::decodeAlertStatus(uint16_t alertStatus)
+    {
+        return
         {
             !!((alertStatus) & (1<<11)),
             !!((alertStatus) & (1<<10)),
@@ -487,12 +605,91 @@ namespace LowLevelEmbedded::Devices::Monitoring
             !!((alertStatus) & (1<<4)),
             !!((alertStatus) & (1<<3)),
             !!((alertStatus) & (1<<2)),
-            !((alertStatus) & (1<<0))
+            !((alertStatus) & (1<<0)),
+            !!((alertStatus) & (1<<1))
         };
+    }
+
+    void INA228::OnAlertInterrupt()
+    {
+        _alertPending.store(true, std::memory_order_release);
+    }
+
+    bool INA228::ProcessAlert()
+    {
+        if (!_alertPending.exchange(false, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        uint8_t data[3];
+        if (!readRegister(DIAG_ALRT, data, 2))
+        {
+            // Try again on the next call
+            _alertPending.store(true, std::memory_order_release);
+            return false;
+        }
+
+        INA228_Sample sample;
+        sample.AlertStatus = decodeAlertStatus((static_cast<uint16_t>(data[0]) << 8) | data[1]);
+
+        if (sample.AlertStatus.ConversionReady)
+        {
+            // ADC_CONFIG MODE bits: bit 0 = bus voltage, bit 1 = shunt voltage, bit 2 = temperature
+            const bool busConverted = (_config.Mode & 0x01) != 0;
+            const bool shuntConverted = (_config.Mode & 0x02) != 0;
+            const bool temperatureConverted = (_config.Mode & 0x04) != 0;
+
+            if (shuntConverted)
+            {
+                if (!readRegister(VSHUNT, data, 3)) return false;
+                sample.ShuntVoltage = decodeShuntVoltage(
+                    (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2]);
+                if (!readRegister(CURRENT, data, 3)) return false;
+                sample.Current = decodeCurrent(
+                    (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2]);
+                sample.Updated |= INA228_Sample::SHUNT_VOLTAGE | INA228_Sample::CURRENT;
+            }
+            if (busConverted)
+            {
+                if (!readRegister(VBUS, data, 3)) return false;
+                sample.BusVoltage = decodeBusVoltage(
+                    (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2]);
+                sample.Updated |= INA228_Sample::BUS_VOLTAGE;
+            }
+            if (busConverted && shuntConverted)
+            {
+                if (!readRegister(POWER, data, 3)) return false;
+                sample.Power = decodePower(
+                    (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2]);
+                sample.Updated |= INA228_Sample::POWER;
+            }
+            if (temperatureConverted)
+            {
+                if (!readRegister(DIETEMP, data, 2)) return false;
+                sample.DieTemperature = decodeTemperature((static_cast<uint16_t>(data[0]) << 8) | data[1]);
+                sample.Updated |= INA228_Sample::TEMPERATURE;
+            }
+        }
 
+        if (!_samples.Push(sample))
+        {
+            _droppedSamples.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
         return true;
     }
 
+    bool INA228::TryGetSample(INA228_Sample& sample)
+    {
+        return _samples.Pop(sample);
+    }
+
+    uint32_t INA228::DroppedSamples() const
+    {
+        return _droppedSamples.load(std::memory_order_relaxed);
+    }
+
     bool INA228::Reset(bool resetConfiguration)
     {
         // Read current CONFIG register
@@ -538,4 +735,164 @@ namespace LowLevelEmbedded::Devices::Monitoring
         return (manufacturerId == 0x5449);
     }
 
+    // INA228_EnergyAccumulator
+
+    namespace
+    {
+        constexpr uint64_t ACCUMULATOR_RANGE = 1ULL << 40;
+        constexpr uint64_t ACCUMULATOR_MASK = ACCUMULATOR_RANGE - 1;
+
+        int64_t signExtend40(uint64_t value)
+        {
+            value &= ACCUMULATOR_MASK;
+            if (value & (1ULL << 39))
+            {
+                value |= ~ACCUMULATOR_MASK;
+            }
+            return static_cast<int64_t>(value);
+        }
+    }
+
+    bool INA228_EnergyAccumulator::Update(uint32_t currentTimeInms)
+    {
+        // DIAG_ALRT first: reading ENERGY and CHARGE clears their overflow flags
+        INA228_DiagAlertStatus alertStatus {};
+        if (_readOverflowFlags && !_device->ReadAlertStatus(alertStatus))
+        {
+            return false;
+        }
+
+        uint64_t energyRegister;
+        uint64_t chargeRegister;
+        if (!_device->ReadAccumulatorRegisters(energyRegister, chargeRegister))
+        {
+            return false;
+        }
+
+        if (_initialized)
+        {
+            // Modular difference handles one wrap of the register between two updates
+            uint64_t energyDelta = (energyRegister - _lastEnergyRegister) & ACCUMULATOR_MASK;
+            if (alertStatus.EnergyRegisterOverflow)
+            {
+                _overflowCount++;
+                if (energyRegister >= _lastEnergyRegister)
+                {
+                    // Wrapped and passed the previous value again
+                    energyDelta += ACCUMULATOR_RANGE;
+                }
+            }
+            else if (!_readOverflowFlags && (energyRegister < _lastEnergyRegister))
+            {
+                _overflowCount++;
+            }
+            _energyCounts += static_cast<int64_t>(energyDelta);
+
+            // Charge is signed, a flagged overflow cannot be disambiguated beyond the modular difference
+            if (alertStatus.ChargeRegisterOverflow)
+            {
+                _overflowCount++;
+            }
+            _chargeCounts += signExtend40(chargeRegister - _lastChargeRegister);
+        }
+        _initialized = true;
+        _lastEnergyRegister = energyRegister;
+        _lastChargeRegister = chargeRegister;
+
+        _history[_historyHead] = {
+            currentTimeInms,
+            _energyCounts,
+            _chargeCounts
+        };
+        _historyHead = (_historyHead + 1) % HISTORY_SIZE;
+        if (_historyCount < HISTORY_SIZE)
+        {
+            _historyCount++;
+        }
+        return true;
+    }
+
+    void INA228_EnergyAccumulator::Reset()
+    {
+        _initialized = false;
+        _energyCounts = 0;
+        _chargeCounts = 0;
+        _overflowCount = 0;
+        _historyCount = 0;
+        _historyHead = 0;
+    }
+
+    unitsnet_cpp::Energy INA228_EnergyAccumulator::TotalEnergy() const
+    {
+        // double: a float mantissa cannot hold the 64-bit count
+        return unitsnet_cpp::Energy::from_joules(static_cast<float>(
+            static_cast<double>(_energyCounts) * _device->CurrentLSB().amperes() * 3.2 * 16.0));
+    }
+
+    unitsnet_cpp::ElectricCharge INA228_EnergyAccumulator::TotalCharge() const
+    {
+        return unitsnet_cpp::ElectricCharge::from_coulombs(static_cast<float>(
+            static_cast<double>(_chargeCounts) * _device->CurrentLSB().amperes()));
+    }
+
+    const INA228_EnergyAccumulator::HistoryEntry& INA228_EnergyAccumulator::newestEntry() const
+    {
+        return _history[(_historyHead + HISTORY_SIZE - 1) % HISTORY_SIZE];
+    }
+
+    const INA228_EnergyAccumulator::HistoryEntry* INA228_EnergyAccumulator::windowStart(
+        unitsnet_cpp::Duration window) const
+    {
+        if (_historyCount < 2)
+        {
+            return nullptr;
+        }
+
+        const HistoryEntry& newest = newestEntry();
+        const auto windowInms = static_cast<uint32_t>(window.milliseconds());
+
+        // Walk back from the second newest entry to the oldest entry that still lies inside the window
+        const HistoryEntry* start = nullptr;
+        for (size_t age = 1; age < _historyCount; age++)
+        {
+            const HistoryEntry& entry = _history[(_historyHead + HISTORY_SIZE - 1 - age) % HISTORY_SIZE];
+            start = &entry;
+            if (newest.TimeInms - entry.TimeInms >= windowInms)
+            {
+                break;
+            }
+        }
+        if (start->TimeInms == newest.TimeInms)
+        {
+            return nullptr;
+        }
+        return start;
+    }
+
+    unitsnet_cpp::Power INA228_EnergyAccumulator::AveragePower(unitsnet_cpp::Duration window) const
+    {
+        const HistoryEntry* start = windowStart(window);
+        if (start == nullptr)
+        {
+            return unitsnet_cpp::Power::from_watts(0.0f);
+        }
+        const HistoryEntry& newest = newestEntry();
+        const double joules = static_cast<double>(newest.Energy - start->Energy) *
+                              _device->CurrentLSB().amperes() * 3.2 * 16.0;
+        const double seconds = static_cast<double>(newest.TimeInms - start->TimeInms) / 1000.0;
+        return unitsnet_cpp::Power::from_watts(static_cast<float>(joules / seconds));
+    }
+
+    unitsnet_cpp::ElectricCurrent INA228_EnergyAccumulator::AverageCurrent(unitsnet_cpp::Duration window) const
+    {
+        const HistoryEntry* start = windowStart(window);
+        if (start == nullptr)
+        {
+            return unitsnet_cpp::ElectricCurrent::from_amperes(0.0f);
+        }
+        const HistoryEntry& newest = newestEntry();
+        const double coulombs = static_cast<double>(newest.Charge - start->Charge) * _device->CurrentLSB().amperes();
+        const double seconds = static_cast<double>(newest.TimeInms - start->TimeInms) / 1000.0;
+        return unitsnet_cpp::ElectricCurrent::from_amperes(static_cast<float>(coulombs / seconds));
+    }
 }
@@ -8,7 +8,9 @@
 #include <Energy.hpp>
 #include <Power.hpp>
 #include <Temperature.hpp>
+#include <atomic>
 #include "LLE_I2C.h"
+#include "LockFreeQueue.h"
 
 
 namespace LowLevelEmbedded::Devices::Monitoring
@@ -50,6 +52,50 @@ namespace LowLevelEmbedded::Devices::Monitoring
         bool BusVoltageUnderLimit;
         bool PowerOverLimit;
         bool MemoryChecksumError;
+        bool ConversionReady;
+    };
+
+    struct INA228_Snapshot
+    {
+        unitsnet_cpp::ElectricPotential ShuntVoltage =
+            unitsnet_cpp::ElectricPotential::from_volts(0.0f);
+        unitsnet_cpp::ElectricPotential BusVoltage =
+            unitsnet_cpp::ElectricPotential::from_volts(0.0f);
+        unitsnet_cpp::Temperature DieTemperature =
+            unitsnet_cpp::Temperature::from_degrees_celsius(0.0f);
+        unitsnet_cpp::ElectricCurrent Current =
+            unitsnet_cpp::ElectricCurrent::from_amperes(0.0f);
+        unitsnet_cpp::Power Power =
+            unitsnet_cpp::Power::from_watts(0.0f);
+        // Only filled in when the snapshot was read with includeAccumulators
+        unitsnet_cpp::Energy Energy =
+            unitsnet_cpp::Energy::from_joules(0.0f);
+        unitsnet_cpp::ElectricCharge Charge =
+            unitsnet_cpp::ElectricCharge::from_coulombs(0.0f);
+    };
+
+    /// A result of the alert driven acquisition, see INA228::ProcessAlert
+    struct INA228_Sample
+    {
+        // Bits in Updated, telling which fields of this sample hold new values
+        static constexpr uint8_t BUS_VOLTAGE = 0x01;
+        static constexpr uint8_t SHUNT_VOLTAGE = 0x02;
+        static constexpr uint8_t TEMPERATURE = 0x04;
+        static constexpr uint8_t CURRENT = 0x08;
+        static constexpr uint8_t POWER = 0x10;
+
+        uint8_t Updated = 0;
+        unitsnet_cpp::ElectricPotential ShuntVoltage =
+            unitsnet_cpp::ElectricPotential::from_volts(0.0f);
+        unitsnet_cpp::ElectricPotential BusVoltage =
+            unitsnet_cpp::ElectricPotential::from_volts(0.0f);
+        unitsnet_cpp::Temperature DieTemperature =
+            unitsnet_cpp::Temperature::from_degrees_celsius(0.0f);
+        unitsnet_cpp::ElectricCurrent Current =
+            unitsnet_cpp::ElectricCurrent::from_amperes(0.0f);
+        unitsnet_cpp::Power Power =
+            unitsnet_cpp::Power::from_watts(0.0f);
+        INA228_DiagAlertStatus AlertStatus {};
     };
 
     /**
@@ -62,6 +108,9 @@ namespace LowLevelEmbedded::Devices::Monitoring
      */
     class INA228 : II2CDevice
     {
+    public:
+        static constexpr size_t SAMPLE_QUEUE_SIZE = 8;
+
     private:
         II2CAccess* _i2CAccess;
         uint8_t _slaveAddress;
@@ -70,6 +119,9 @@ namespace LowLevelEmbedded::Devices::Monitoring
             unitsnet_cpp::ElectricCurrent::from_amperes(0.0f);
         uint8_t _registerPointer = 0xFF;
         INA228_Config _config;
+        std::atomic<bool> _alertPending { false };
+        Utility::LockFreeQueue<INA228_Sample, SAMPLE_QUEUE_SIZE> _samples;
+        std::atomic<uint32_t> _droppedSamples { 0 };
 
         bool write16bitWord(uint8_t reg, uint16_t value);
         bool read16bitWord(uint8_t reg, uint16_t& value);
@@ -77,9 +129,20 @@ namespace LowLevelEmbedded::Devices::Monitoring
         bool read24bitWord(uint8_t reg, uint32_t& value);
         bool write40bitWord(uint8_t reg, uint64_t value);
         bool read40bitWord(uint8_t reg, uint64_t& value);
+        bool readRegister(uint8_t reg, uint8_t* data, size_t length);
         void setRegisterPointerOnRead(uint8_t reg);
         bool calibrate(unitsnet_cpp::ElectricCurrent maxCurrentExpected);
 
+        // Conversions from raw register contents (big endian, as read from the device)
+        unitsnet_cpp::ElectricPotential decodeShuntVoltage(uint32_t reg24) const;
+        static unitsnet_cpp::ElectricPotential decodeBusVoltage(uint32_t reg24);
+        static unitsnet_cpp::Temperature decodeTemperature(uint16_t reg16);
+        unitsnet_cpp::ElectricCurrent decodeCurrent(uint32_t reg24) const;
+        unitsnet_cpp::Power decodePower(uint32_t reg24) const;
+        unitsnet_cpp::Energy decodeEnergy(uint64_t reg40) const;
+        unitsnet_cpp::ElectricCharge decodeCharge(uint64_t reg40) const;
+        static INA228_DiagAlertStatus decodeAlertStatus(uint16_t reg16);
+
         // INA228 Register Addresses
         enum Registers : uint8_t {
             CONFIG = 0x00,
@@ -192,6 +255,34 @@ namespace LowLevelEmbedded::Devices::Monitoring
          */
         unitsnet_cpp::ElectricCharge ReadCharge();
 
+        /**
+         * @brief Reads shunt voltage, bus voltage, die temperature, current and power in one pass.
+         *
+         * The INA228 does not auto-increment its register pointer, so every register needs its own
+         * access. Each one is done as a single combined pointer-write/read transaction (repeated start),
+         * instead of the separate pointer write and read used by the individual Read methods, and all values
+         * are decoded after the bus traffic is done.
+         *
+         * @param snapshot out parameter receiving the measurements
+         * @param includeAccumulators also read the ENERGY and CHARGE accumulators
+         * @return True if all registers were read, false otherwise (snapshot is left unchanged).
+         */
+        bool ReadSnapshot(INA228_Snapshot& snapshot, bool includeAccumulators = false);
+
+        /**
+         * @brief Reads the raw 40-bit ENERGY and CHARGE accumulator registers.
+         *
+         * @param energy out parameter for the unsigned ENERGY register
+         * @param charge out parameter for the CHARGE register (40-bit two's complement, not sign extended)
+         * @return True if both registers were read, false otherwise.
+         */
+        bool ReadAccumulatorRegisters(uint64_t& energy, uint64_t& charge);
+
+        /**
+         * @brief The current LSB selected by Init, one CHARGE count equals this current during one second.
+         */
+        unitsnet_cpp::ElectricCurrent CurrentLSB() const;
+
         /**
          * @brief Sets the shunt voltage over-limit threshold.
          *
@@ -263,6 +354,43 @@ namespace LowLevelEmbedded::Devices::Monitoring
          */
         bool ReadAlertStatus(INA228_DiagAlertStatus& alert_status);
 
+        /**
+         * @brief Notifies the driver that the ALERT pin became active.
+         *
+         * Call this from the ALERT pin interrupt handler. It only records the event, all bus access is
+         * deferred to ProcessAlert.
+         */
+        void OnAlertInterrupt();
+
+        /**
+         * @brief Handles a pending alert, call this from task context.
+         *
+         * Does nothing (no bus access) when no alert was signalled with OnAlertInterrupt. Otherwise DIAG_ALRT is
+         * read, which also clears the alert. When it reports conversion ready, only the registers converted in
+         * the configured ADC mode are read (bus voltage, shunt voltage/current, power, temperature). The result
+         * is pushed to the sample queue; when the queue is full the sample is dropped and counted.
+         *
+         * Enable INA228_Config::ConversionReadyAssert to get an alert at the end of every conversion.
+         * Reading DIAG_ALRT elsewhere clears the conversion ready flag, so an INA228_EnergyAccumulator on the same
+         * device must be constructed with readOverflowFlags = false.
+         *
+         * @return True if a sample was queued.
+         */
+        bool ProcessAlert();
+
+        /**
+         * @brief Takes the oldest sample from the queue filled by ProcessAlert.
+         *
+         * @param sample out parameter for the sample
+         * @return True if a sample was available.
+         */
+        bool TryGetSample(INA228_Sample& sample);
+
+        /**
+         * @brief The number of samples dropped because the sample queue was full.
+         */
+        uint32_t DroppedSamples() const;
+
         /**
          * @brief Reset.
          *
@@ -278,4 +406,95 @@ namespace LowLevelEmbedded::Devices::Monitoring
          */
         bool IsDeviceReady() override;
     };
+
+    /**
+     * @class INA228_EnergyAccumulator
+     * @brief Extends the 40-bit INA228 energy and charge accumulators to 64 bits and keeps a short history
+     * for windowed averages.
+     *
+     * Call Update periodically. Each call reads the two accumulator registers and adds the difference to the
+     * previous call to the 64-bit totals, so the hardware accumulators never have to be reset. A register wrap
+     * between two calls is handled by modular arithmetic.
+     *
+     * With readOverflowFlags, Update also reads DIAG_ALRT first, and uses the overflow flags to detect an ENERGY
+     * register that wrapped past its previous value (more than one full range between calls). Reading DIAG_ALRT
+     * clears the conversion ready flag (and latched alerts), which takes the events away from INA228::ProcessAlert,
+     * so do not combine the two on one device; without the flags Update must be called at least once per full
+     * register range.
+     */
+    class INA228_EnergyAccumulator
+    {
+    public:
+        static constexpr size_t HISTORY_SIZE = 16;
+
+        /**
+         * @param device the INA228 whose accumulators are extended
+         * @param readOverflowFlags read DIAG_ALRT on every Update, false when INA228::ProcessAlert is used
+         */
+        explicit INA228_EnergyAccumulator(INA228* device, bool readOverflowFlags = true)
+            : _device(device), _readOverflowFlags(readOverflowFlags)
+        {
+        }
+
+        /**
+         * @brief Samples the hardware accumulators and updates the totals.
+         *
+         * @param currentTimeInms a monotonic millisecond tick, e.g. Utility::millis()
+         * @return True if the registers were read, false otherwise (totals are unchanged).
+         */
+        bool Update(uint32_t currentTimeInms);
+
+        /// Clears the totals and the history, the hardware accumulators are left running.
+        void Reset();
+
+        unitsnet_cpp::Energy TotalEnergy() const;
+        unitsnet_cpp::ElectricCharge TotalCharge() const;
+
+        /// The total in ENERGY register counts (3.2 * 16 * CURRENT_LSB joule each), without rounding
+        int64_t EnergyCounts() const { return _energyCounts; }
+
+        /// The total in CHARGE register counts (CURRENT_LSB coulomb each), without rounding
+        int64_t ChargeCounts() const { return _chargeCounts; }
+
+        /**
+         * @brief The average power over the most recent window.
+         *
+         * The window is limited to the span of the stored history (HISTORY_SIZE updates).
+         * @return The average power, 0 W when fewer than two updates were done.
+         */
+        unitsnet_cpp::Power AveragePower(unitsnet_cpp::Duration window) const;
+
+        /**
+         * @brief The average current over the most recent window, derived from the charge accumulator.
+         *
+         * @return The average current, 0 A when fewer than two updates were done.
+         */
+        unitsnet_cpp::ElectricCurrent AverageCurrent(unitsnet_cpp::Duration window) const;
+
+        /// The number of hardware register overflows seen (ENERGY and CHARGE together)
+        uint32_t OverflowCount() const { return _overflowCount; }
+
+    private:
+        struct HistoryEntry
+        {
+            uint32_t TimeInms;
+            int64_t Energy;
+            int64_t Charge;
+        };
+
+        INA228* _device;
+        bool _readOverflowFlags;
+        bool _initialized = false;
+        uint64_t _lastEnergyRegister = 0;
+        uint64_t _lastChargeRegister = 0;
+        int64_t _energyCounts = 0;
+        int64_t _chargeCounts = 0;
+        uint32_t _overflowCount = 0;
+        HistoryEntry _history[HISTORY_SIZE] = {};
+        size_t _historyCount = 0;
+        size_t _historyHead = 0;
+
+        const HistoryEntry* windowStart(unitsnet_cpp::Duration window) const;
+        const HistoryEntry& newestEntry() const;
+    };
 }
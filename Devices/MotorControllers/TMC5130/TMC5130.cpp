@@ -6,11 +6,72 @@
 #include "TMC5130_RegisterAccess.h"
 #include "TMC5130_Utils.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <ulog.h>
 
 namespace LowLevelEmbedded::Devices::MotorControllers
 {
+    // Register access permissions:
+    //   0x00: none (reserved)
+    //   0x01: read
+    //   0x02: write
+    //   0x03: read/write
+    //   0x13: read/write, seperate functions/values for reading or writing
+    //   0x21: read, flag register (read to clear)
+    //   0x42: write, has hardware presets on reset
+    static constexpr uint8_t tmc5130_defaultRegisterAccess[TMC5130_REGISTER_COUNT] = {
+        //  0     1     2     3     4     5     6     7     8     9     A     B C D
+        //  E     F
+        0x03, 0x21, 0x01, 0x02, 0x13, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x00 - 0x0F
+        0x02, 0x02, 0x01, 0x02, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x10 - 0x1F
+        0x03, 0x03, 0x01, 0x06, 0x02, 0x02, 0x02, 0x02, 0x02, 0x00, 0x02, 0x06, 0x02, 0x03, 0x00, 0x00, // 0x20 - 0x2F
+        0x00, 0x00, 0x00, 0x02, 0x03, 0x21, 0x01, 0x00, 0x03, 0x03, 0x02, 0x21, 0x01, 0x00, 0x00, 0x00, // 0x30 - 0x3F
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x40 - 0x4F
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x50 - 0x5F
+        0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x01, 0x01, 0x03, 0x02, 0x02, 0x01, // 0x60 - 0x6F
+        0x42, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 // 0x70 - 0x7F
+    };
+
+    // Position of every writable register in the shadow register array, 0xFF for registers without shadow
+    static constexpr uint8_t TMC5130_NO_SHADOW = 0xFF;
+    static constexpr std::array<uint8_t, TMC5130_REGISTER_COUNT> tmc5130_shadowIndex = []
+    {
+        std::array<uint8_t, TMC5130_REGISTER_COUNT> index {};
+        uint8_t next = 0;
+        for (size_t address = 0; address < TMC5130_REGISTER_COUNT; address++)
+        {
+            index[address] = TMC_IS_WRITABLE(tmc5130_defaultRegisterAccess[address]) ? next++ : TMC5130_NO_SHADOW;
+        }
+        return index;
+    }();
+
+    static_assert(std::count_if(tmc5130_defaultRegisterAccess, tmc5130_defaultRegisterAccess + TMC5130_REGISTER_COUNT,
+                                [](const uint8_t access) { return TMC_IS_WRITABLE(access) != 0; }) ==
+                      TMC5130_SHADOW_REGISTER_COUNT,
+                  "TMC5130_SHADOW_REGISTER_COUNT does not match the writable registers of the access table");
+
+    // Register constants (only required for 0x42 registers, since we do not have
+    // any way to find out the content but want to hold the actual value in the
+    // shadow register so an application (i.e. the TMCL IDE) can still display
+    // the values. This only works when the register content is constant.
+    static const TMCRegisterConstant tmc5130_RegisterConstants[] = {
+        // Use ascending addresses!
+        {0x60, (int32_t)0xAAAAB554}, // MSLUT[0]
+        {0x61, 0x4A9554AA}, // MSLUT[1]
+        {0x62, 0x24492929}, // MSLUT[2]
+        {0x63, 0x10104222}, // MSLUT[3]
+        {0x64, (int32_t)0xFBFFFFFF}, // MSLUT[4]
+        {0x65, (int32_t)0xB5BB777D}, // MSLUT[5]
+        {0x66, 0x49295556}, // MSLUT[6]
+        {0x67, 0x00404222}, // MSLUT[7]
+        {0x68, (int32_t)0xFFFF8056}, // MSLUTSEL
+        {0x69, 0x00F70000}, // MSLUTSTART
+        {0x70, 0x00050480} // PWMCONF
+    };
+
     TMC5130::TMC5130(ISPIAccess* spiAccess) { this->_SPIAccess = spiAccess; }
 
     void TMC5130::StopMovement()
@@ -24,6 +85,9 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         log_info("TMC5130: Stopping");
         _writeInt(TMC5130_AMAX, AccDecPPSToMotorUnits(dec));
         _writeInt(TMC5130_VMAX, 0);
+        // A positioning ramp brakes with DMAX and resumes towards XTARGET on the next VMAX write, in velocity
+        // mode the motor brakes with AMAX and stays at standstill
+        _writeIntIfChanged(TMC5130_RAMPMODE, TMC5130_MODE_VELPOS);
         this->MotorState = msConstantVelocityRampingDown;
     }
 
@@ -42,12 +106,45 @@ namespace LowLevelEmbedded::Devices::MotorControllers
             decelerationInPulsesPerSecondSquared);
         // Set Current for Motor
         _activateMoveCurrent();
+        // XTARGET first, a stop in velocity mode leaves the old target in it
+        _writeInt(TMC5130_XTARGET, position);
         _writeInt(TMC5130_RAMPMODE, TMC5130_MODE_POSITION);
         _writeInt(TMC5130_VMAX, SpeedPPSToMotorUnits(speedMax));
         _writeInt(TMC5130_AMAX,
             AccDecPPSToMotorUnits(accelerationInPulsesPerSecondSquared));
         _writeInt(TMC5130_DMAX,
             AccDecPPSToMotorUnits(decelerationInPulsesPerSecondSquared));
+        this->LastTargetPosition = position;
+        this->MotorState = msTrajectory;
+    }
+
+    void TMC5130::MoveToPositionInMotorUnits(const int32_t position, const int32_t vmax, const int32_t amax,
+                                             const int32_t dmax)
+    {
+        // XTARGET before the ramp: after StopMovement switched to velocity mode it still holds the old target,
+        // which the ramp generator would head for as soon as RAMPMODE and VMAX are written
+        if (this->MotorState != msTrajectory)
+        {
+            _activateMoveCurrent();
+        }
+        SetTargetPosition(position);
+        SetPositioningRamp(vmax, amax, dmax);
+    }
+
+    void TMC5130::SetPositioningRamp(const int32_t vmax, const int32_t amax, const int32_t dmax)
+    {
+        if (this->MotorState != msTrajectory)
+        {
+            _activateMoveCurrent();
+        }
+        _writeIntIfChanged(TMC5130_RAMPMODE, TMC5130_MODE_POSITION);
+        _writeIntIfChanged(TMC5130_VMAX, vmax);
+        _writeIntIfChanged(TMC5130_AMAX, amax);
+        _writeIntIfChanged(TMC5130_DMAX, dmax);
+    }
+
+    void TMC5130::SetTargetPosition(const int32_t position)
+    {
         _writeInt(TMC5130_XTARGET, position);
         this->LastTargetPosition = position;
         this->MotorState = msTrajectory;
@@ -137,53 +234,80 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         this->MotorState = msTimedConstantVelocityRampUp;
     }
 
+    // Power-on value of a register: the known constant for hardware preset registers, 0 for all others
+    static int32_t tmc5130_hardwareDefault(const uint8_t address)
+    {
+        for (const TMCRegisterConstant& constant : tmc5130_RegisterConstants)
+        {
+            if (constant.address == address) return constant.value;
+        }
+        return 0;
+    }
+
     /**
      * Writes the motor driver's configuration settings to the relevant hardware
-     * registers. This function determines the next actionable register based on
-     * the current configuration state (restore or reset) and writes the appropriate
-     * value. If all necessary registers are processed, the configuration state is
-     * set to CONFIG_READY.
+     * registers, at most _configWriteBudget registers per call. If all necessary
+     * registers are processed, the configuration state is set to CONFIG_READY.
      *
      * This function handles:
-     * - Register processing for restoring configuration values from the shadow
-     *   register during CONFIG_RESTORE state.
+     * - Restoring the shadow registers during CONFIG_RESTORE state. Registers
+     *   that already hold their power-on value are skipped, so after a brown-out
+     *   only the registers that were actually changed are written.
      * - Register resetting using default values during CONFIG_RESET state.
-     * - Transitions to CONFIG_READY state after completing all required writes.
+     * - Transitions to CONFIG_READY state after completing all required writes,
+     *   clearing the reset flag in GSTAT.
      */
     void TMC5130::_writeConfiguration()
     {
-        log_info("TMC5130 #%d: Writing configuration", ChipID);
         uint8_t* ptr = &(this->_configIndex);
-        const int32_t* settings;
+        uint8_t written = 0;
 
-        if (this->_configState == CONFIG_RESTORE)
+        while ((*ptr < TMC5130_REGISTER_COUNT) && (written < this->_configWriteBudget))
         {
-            settings = this->_shadowRegister;
-            // Find the next restorable register
-            while ((*ptr < TMC5130_REGISTER_COUNT) && !TMC_IS_RESTORABLE(this->_registerAccess[*ptr]))
+            const uint8_t address = *ptr;
+            (*ptr)++;
+            if (this->_configState == CONFIG_RESTORE)
             {
-                (*ptr)++;
+                const uint8_t access = tmc5130_defaultRegisterAccess[address] | (_isDirty(address) ? TMC_ACCESS_DIRTY : 0);
+                if (!TMC_IS_RESTORABLE(access)) continue;
+                if (_shadow(address) == tmc5130_hardwareDefault(address)) continue;
+                _writeInt(address, _shadow(address));
             }
-        }
-        else
-        {
-            settings = this->_registerResetState;
-            // Find the next resettable register
-            while ((*ptr < TMC5130_REGISTER_COUNT) && !TMC_IS_RESETTABLE(this->_registerAccess[*ptr]))
+            else
             {
-                (*ptr)++;
+                if (!TMC_IS_RESETTABLE(tmc5130_defaultRegisterAccess[address])) continue;
+                _writeInt(address, this->_registerResetState[address]);
             }
+            written++;
+            this->_configWrites++;
         }
 
-        if (*ptr < TMC5130_REGISTER_COUNT)
+        if (*ptr >= TMC5130_REGISTER_COUNT) // Finished configuration
         {
-            _writeInt(*ptr, settings[*ptr]);
-            (*ptr)++;
+            // Reading GSTAT clears the reset flag of the power-on or brown-out, otherwise AutoRestore would
+            // restore the configuration that was just written
+            _readInt(TMC5130_GSTAT);
+            log_info("TMC5130 #%d: Configuration written (%d registers)", ChipID, this->_configWrites);
+            this->_configState = CONFIG_READY;
         }
-        else // Finished configuration
+    }
+
+    bool TMC5130::Restore()
+    {
+        if (this->_configState != CONFIG_READY)
         {
-            this->_configState = CONFIG_READY;
+            return false;
         }
+        log_info("TMC5130 #%d: Restoring configuration", ChipID);
+        this->_configState = CONFIG_RESTORE;
+        this->_configIndex = 0;
+        this->_configWrites = 0;
+        return true;
+    }
+
+    void TMC5130::SetConfigurationWriteBudget(const uint8_t registersPerCall)
+    {
+        this->_configWriteBudget = (registersPerCall == 0) ? 1 : registersPerCall;
     }
 
     /**
@@ -196,17 +320,128 @@ namespace LowLevelEmbedded::Devices::MotorControllers
      */
     void TMC5130::PeriodicJob(unitsnet_cpp::Duration elapsedTime)
     {
-        const auto elapsedTimeinMs =
-            static_cast<int32_t>(elapsedTime.milliseconds());
         if (this->_configState != CONFIG_READY)
         {
             _writeConfiguration();
             return;
         }
 
-        const int32_t xactual = _readInt(TMC5130_XACTUAL);
+        if (!IsStatusDue(elapsedTime))
+        {
+            return;
+        }
+
+        static constexpr uint8_t statusRegisters[] = {TMC5130_XACTUAL, TMC5130_RAMPSTAT};
+        int32_t status[2];
+        ReadRegisters(statusRegisters, status, 2);
+        if (this->AutoRestore && ((this->_spiStatus & TMC5130_SPI_STATUS_RESET_FLAG) != 0))
+        {
+            // The driver was reset (e.g. a supply brown-out): write the configuration back first
+            Restore();
+            return;
+        }
+        ProcessStatus(status[0], status[1], elapsedTime);
+    }
+
+    bool TMC5130::IsStatusDue(unitsnet_cpp::Duration elapsedTime)
+    {
+        if (!this->_eventMode)
+        {
+            return true;
+        }
+        const bool event = this->_diagEvent.exchange(false);
+        const auto timeInms = static_cast<int32_t>(elapsedTime.milliseconds());
+        const uint16_t interval = this->_pollIntervalInms[this->MotorState];
+        if (!event &&
+            ((interval == POLL_NEVER) || ((timeInms - this->_lastPollTimeInms) < static_cast<int32_t>(interval))))
+        {
+            return false;
+        }
+        this->_lastPollTimeInms = timeInms;
+        return true;
+    }
+
+    void TMC5130::EnableEventMode(const bool pushPull)
+    {
+        // DIAG0 is the ramp generator interrupt in motion controller mode, DIAG1 follows the stall flag
+        SetField(TMC5130Fields::DIAG0_INT_PUSHPULL, pushPull ? 1 : 0);
+        SetField(TMC5130Fields::DIAG1_POSCOMP_PUSHPULL, pushPull ? 1 : 0);
+        SetField(TMC5130Fields::DIAG1_STALL, 1);
+        CommitFields();
+
+        this->_pollIntervalInms[msIdle] = POLL_NEVER;
+        this->_pollIntervalInms[msConstantVelocity] = POLL_NEVER;
+        this->_pollIntervalInms[msStopped] = 0;
+        this->_pollIntervalInms[msStalled] = 0;
+        this->_pollIntervalInms[msTrajectory] = 100; // position reached is an event, this is a fallback
+        this->_pollIntervalInms[msConstantVelocityRampingDown] = 10;
+        this->_pollIntervalInms[msConstantVelocityRampUp] = 10;
+        this->_pollIntervalInms[msTimedConstantVelocityRampUp] = 10;
+        this->_pollIntervalInms[msTimedConstantVelocity] = 10;
+        this->_pollIntervalInms[msConstantVelocityUntilSwitch] = 10;
+
+        // Read the status once, this also clears events that are already pending in RAMPSTAT
+        this->_diagEvent = true;
+        this->_eventMode = true;
+        log_info("TMC5130 #%d: Event mode enabled", ChipID);
+    }
+
+    void TMC5130::DisableEventMode()
+    {
+        this->_eventMode = false;
+    }
+
+    void TMC5130::OnDiagInterrupt()
+    {
+        this->_diagEvent = true;
+    }
+
+    void TMC5130::SetPollInterval(const MotorState_t state, const uint16_t intervalInms)
+    {
+        if (state < MOTOR_STATE_COUNT)
+        {
+            this->_pollIntervalInms[state] = intervalInms;
+        }
+    }
+
+    uint16_t TMC5130::GetPollInterval(const MotorState_t state) const
+    {
+        return (state < MOTOR_STATE_COUNT) ? this->_pollIntervalInms[state] : 0;
+    }
+
+    int32_t TMC5130::ReadActualPosition()
+    {
+        this->LastKnownPosition = _readInt(TMC5130_XACTUAL);
+        return this->LastKnownPosition;
+    }
+
+    void TMC5130::SetActualPosition(const int32_t position)
+    {
+        // In hold mode the ramp generator ignores XTARGET, so XACTUAL can be changed without a move
+        _writeInt(TMC5130_RAMPMODE, TMC5130_MODE_HOLD);
+        _writeInt(TMC5130_XACTUAL, position);
+        _writeInt(TMC5130_XTARGET, position);
+        _writeInt(TMC5130_RAMPMODE, TMC5130_MODE_POSITION);
+        this->LastKnownPosition = position;
+        this->LastTargetPosition = position;
+    }
+
+    bool TMC5130::IsConfigurationPending() const
+    {
+        return this->_configState != CONFIG_READY;
+    }
+
+    void TMC5130::ProcessStatus(const int32_t xactual, const int32_t rampstatus, unitsnet_cpp::Duration elapsedTime)
+    {
+        const auto elapsedTimeinMs =
+            static_cast<int32_t>(elapsedTime.milliseconds());
         LastKnownPosition = xactual;
-        const int32_t rampstatus = _readInt(TMC5130_RAMPSTAT);
+        // A stallGuard stop (sg_stop in SW_MODE) ends any motion
+        if ((rampstatus & TMC5130_RS_EV_STOP_SG_MASK) && (this->MotorState != msIdle) &&
+            (this->MotorState != msStopped))
+        {
+            this->MotorState = msStalled;
+        }
         const MotorState_t tempMotorState = this->MotorState;
         bool switchState = false;
         switch (tempMotorState)
@@ -310,46 +545,6 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         }
     }
 
-    // Register access permissions:
-    //   0x00: none (reserved)
-    //   0x01: read
-    //   0x02: write
-    //   0x03: read/write
-    //   0x13: read/write, seperate functions/values for reading or writing
-    //   0x21: read, flag register (read to clear)
-    //   0x42: write, has hardware presets on reset
-    static const uint8_t tmc5130_defaultRegisterAccess[TMC5130_REGISTER_COUNT] = {
-        //  0     1     2     3     4     5     6     7     8     9     A     B C D
-        //  E     F
-        0x03, 0x21, 0x01, 0x02, 0x13, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x00 - 0x0F
-        0x02, 0x02, 0x01, 0x02, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x10 - 0x1F
-        0x03, 0x03, 0x01, 0x06, 0x02, 0x02, 0x02, 0x02, 0x02, 0x00, 0x02, 0x06, 0x02, 0x03, 0x00, 0x00, // 0x20 - 0x2F
-        0x00, 0x00, 0x00, 0x02, 0x03, 0x21, 0x01, 0x00, 0x03, 0x03, 0x02, 0x21, 0x01, 0x00, 0x00, 0x00, // 0x30 - 0x3F
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x40 - 0x4F
-        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0x50 - 0x5F
-        0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x01, 0x01, 0x03, 0x02, 0x02, 0x01, // 0x60 - 0x6F
-        0x42, 0x01, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 // 0x70 - 0x7F
-    };
-
-    // Register constants (only required for 0x42 registers, since we do not have
-    // any way to find out the content but want to hold the actual value in the
-    // shadow register so an application (i.e. the TMCL IDE) can still display
-    // the values. This only works when the register content is constant.
-    static const TMCRegisterConstant tmc5130_RegisterConstants[] = {
-        // Use ascending addresses!
-        {0x60, (int32_t)0xAAAAB554}, // MSLUT[0]
-        {0x61, 0x4A9554AA}, // MSLUT[1]
-        {0x62, 0x24492929}, // MSLUT[2]
-        {0x63, 0x10104222}, // MSLUT[3]
-        {0x64, (int32_t)0xFBFFFFFF}, // MSLUT[4]
-        {0x65, (int32_t)0xB5BB777D}, // MSLUT[5]
-        {0x66, 0x49295556}, // MSLUT[6]
-        {0x67, 0x00404222}, // MSLUT[7]
-        {0x68, (int32_t)0xFFFF8056}, // MSLUTSEL
-        {0x69, 0x00F70000}, // MSLUTSTART
-        {0x70, 0x00050480} // PWMCONF
-    };
-
     /**
      * Resets the TMC5130 motor controller to its default state. This function
      * clears the dirty bits, wipes shadow registers, and updates the configuration
@@ -361,47 +556,46 @@ namespace LowLevelEmbedded::Devices::MotorControllers
     bool TMC5130::Reset()
     {
         log_info("TMC5130 #%d: Resetting controller", ChipID);
-        if (this->_configState != CONFIG_READY)
+        if ((this->_configState != CONFIG_READY) || (this->_registerResetState == nullptr))
         {
             return false;
         }
         // Reset the dirty bits and wipe the shadow registers
-        for (size_t i = 0; i < TMC5130_REGISTER_COUNT; i++)
+        for (int32_t& shadow : this->_shadowRegister)
+        {
+            shadow = 0;
+        }
+        for (size_t i = 0; i < (TMC5130_REGISTER_COUNT / 32); i++)
         {
-            this->_registerAccess[i] &= ~TMC_ACCESS_DIRTY;
-            this->_shadowRegister[i] = 0;
+            this->_dirtyRegisters[i] = 0;
+            this->_pendingFieldWrites[i] = 0;
         }
 
         this->_configState = CONFIG_RESET;
         this->_configIndex = 0;
+        this->_configWrites = 0;
 
-        log_info("TMC5130 #%d: Reset successful");
+        log_info("TMC5130 #%d: Reset successful", ChipID);
         return true;
     }
 
     /**
      * Initializes the TMC5130 motor controller with the specified configuration and
      * register reset states. This function sets the initial motor state to idle,
-     * prepares the configuration structure, and populates the shadow register and
-     * access states for the motor controller. It is designed to prepare the motor
+     * and keeps a reference to the register reset states. It is designed to prepare the motor
      * driver for operation and ensure a consistent startup state.
      *
      * @param config A pointer to the ConfigurationTypeDef structure that holds the
      * configuration data for the motor controller.
      * @param registerResetState A pointer to an array of int32_t values
-     * representing the default reset state for each register, used to initialize
-     * shadow registers.
+     * representing the default reset state for each register. The array is not
+     * copied and must stay valid, a static const table stays in flash.
      */
     void TMC5130::Init(const int32_t* registerResetState)
     {
         this->LastStoppedPosition = 0;
         this->MotorState = msIdle;
-
-        for (size_t i = 0; i < TMC5130_REGISTER_COUNT; i++)
-        {
-            this->_registerAccess[i] = tmc5130_defaultRegisterAccess[i];
-            this->_registerResetState[i] = registerResetState[i];
-        }
+        this->_registerResetState = registerResetState;
         log_info("TMC5130 #%d: Initializing motor controller", ChipID);
     }
 
@@ -410,28 +604,58 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         const uint8_t write_address = address | TMC5130_WRITE_BIT;
         uint8_t data[5] = {write_address, x1, x2, x3, x4};
         this->_SPIAccess->ReadWriteSPI(&data[0], 5, this->ChipID, SPIMode::Mode3);
+        this->_spiStatus = data[0];
         const int32_t value = (x1 << 24) | (x2 << 16) | (x3 << 8) | x4;
         // Write to the shadow register and mark the register dirty
         address = TMC_ADDRESS(address);
-        this->_shadowRegister[address] = value;
-        this->_registerAccess[address] |= TMC_ACCESS_DIRTY;
+        _setShadow(address, value);
+        this->_dirtyRegisters[address / 32] |= 1u << (address % 32);
     }
 
-    int32_t TMC5130::_readInt(uint8_t address) const
+    // Sends a read request and returns the data of the previous request
+    int32_t TMC5130::_readDatagram(const uint8_t address)
     {
-        address = TMC_ADDRESS(address);
+        uint8_t data[5] = {address, 0, 0, 0, 0};
+        this->_SPIAccess->ReadWriteSPI(&data[0], 5, this->ChipID, SPIMode::Mode3);
+        this->_spiStatus = data[0];
+        return (data[1] << 24) | (data[2] << 16) | (data[3] << 8) | data[4];
+    }
 
-        // register not readable -> shadow register copy
-        if (!TMC_IS_READABLE(this->_registerAccess[address])) return this->_shadowRegister[address];
+    void TMC5130::ReadRegisters(const uint8_t* addresses, int32_t* values, const size_t count)
+    {
+        // Index of the request whose reply arrives with the next datagram, count when there is none
+        size_t pending = count;
+        for (size_t i = 0; i < count; i++)
+        {
+            const uint8_t address = TMC_ADDRESS(addresses[i]);
 
-        uint8_t data[5] = {0, 0, 0, 0, 0};
+            // register not readable -> shadow register copy
+            if (!TMC_IS_READABLE(tmc5130_defaultRegisterAccess[address]))
+            {
+                values[i] = _shadow(address);
+                continue;
+            }
 
-        data[0] = address;
-        this->_SPIAccess->ReadWriteSPI(&data[0], 5, this->ChipID, SPIMode::Mode3);
-        data[0] = address;
-        this->_SPIAccess->ReadWriteSPI(&data[0], 5, this->ChipID, SPIMode::Mode3);
+            const int32_t reply = _readDatagram(address);
+            if (pending != count) values[pending] = reply;
+            pending = i;
+        }
 
-        return (data[1] << 24) | (data[2] << 16) | (data[3] << 8) | data[4];
+        // Collect the last reply with a request for GCONF, which has no read side effects
+        // (repeating the last address could clear flags of a read-to-clear register)
+        if (pending != count) values[pending] = _readDatagram(TMC5130_GCONF);
+    }
+
+    uint8_t TMC5130::GetSPIStatus() const
+    {
+        return this->_spiStatus;
+    }
+
+    int32_t TMC5130::_readInt(uint8_t address)
+    {
+        int32_t value;
+        ReadRegisters(&address, &value, 1);
+        return value;
     }
 
     void TMC5130::_writeInt(const uint8_t address, const int32_t value)
@@ -439,6 +663,93 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         _writeDatagram(address, BYTE(value, 3), BYTE(value, 2), BYTE(value, 1), BYTE(value, 0));
     }
 
+    void TMC5130::_writeIntIfChanged(const uint8_t address, const int32_t value)
+    {
+        if (_isDirty(address) && (_shadow(address) == value))
+        {
+            return;
+        }
+        _writeInt(address, value);
+    }
+
+    bool TMC5130::_isDirty(const uint8_t address) const
+    {
+        return (this->_dirtyRegisters[address / 32] & (1u << (address % 32))) != 0;
+    }
+
+    int32_t TMC5130::_shadow(const uint8_t address) const
+    {
+        const uint8_t index = tmc5130_shadowIndex[address];
+        return (index == TMC5130_NO_SHADOW) ? 0 : this->_shadowRegister[index];
+    }
+
+    void TMC5130::_setShadow(const uint8_t address, const int32_t value)
+    {
+        const uint8_t index = tmc5130_shadowIndex[address];
+        if (index != TMC5130_NO_SHADOW)
+        {
+            this->_shadowRegister[index] = value;
+        }
+    }
+
+    // The shadow holds the chip's content when the register was written since the last reset, or when it can
+    // only be written (then the shadow is all there is)
+    bool TMC5130::_isShadowValid(const uint8_t address) const
+    {
+        return _isDirty(address) || !TMC_IS_READABLE(tmc5130_defaultRegisterAccess[address]);
+    }
+
+    int32_t TMC5130::ReadField(const TMC5130Field& field)
+    {
+        const uint8_t address = TMC_ADDRESS(field.Address);
+        const int32_t value = _isShadowValid(address) ? _shadow(address) : _readInt(address);
+        return field.Get(value);
+    }
+
+    void TMC5130::SetField(const TMC5130Field& field, const int32_t value)
+    {
+        const uint8_t address = TMC_ADDRESS(field.Address);
+        uint32_t& pendingWord = this->_pendingFieldWrites[address / 32];
+        const uint32_t pendingBit = 1u << (address % 32);
+
+        if ((pendingWord & pendingBit) == 0)
+        {
+            if (!_isShadowValid(address))
+            {
+                _setShadow(address, _readInt(address));
+            }
+            else if (_isDirty(address) && (field.Get(_shadow(address)) == field.Get(field.Set(0, value))))
+            {
+                return; // the chip already has this value
+            }
+        }
+
+        _setShadow(address, field.Set(_shadow(address), value));
+        pendingWord |= pendingBit;
+    }
+
+    void TMC5130::CommitFields()
+    {
+        for (uint8_t word = 0; word < (TMC5130_REGISTER_COUNT / 32); word++)
+        {
+            uint32_t pending = this->_pendingFieldWrites[word];
+            this->_pendingFieldWrites[word] = 0;
+            while (pending != 0)
+            {
+                const uint8_t bit = static_cast<uint8_t>(std::countr_zero(pending));
+                pending &= pending - 1;
+                const uint8_t address = static_cast<uint8_t>(word * 32 + bit);
+                _writeInt(address, _shadow(address));
+            }
+        }
+    }
+
+    void TMC5130::WriteField(const TMC5130Field& field, const int32_t value)
+    {
+        SetField(field, value);
+        CommitFields();
+    }
+
 #define ONE_OVER_SQRT_OF_TWO 0.70711f
 
     inline float calculate_full_scale_current(const float senseResistorValue, const float Vfs)
@@ -466,9 +777,8 @@ namespace LowLevelEmbedded::Devices::MotorControllers
             return false;
         }
 
-        int32_t chopConf = _readInt(TMC5130_CHOPCONF);
         float Vfs = 0.32;
-        if ((chopConf & TMC5130_VSENSE_MASK) > 0)
+        if (ReadField(TMC5130Fields::VSENSE) != 0)
         {
             Vfs = 0.18;
         }
@@ -484,17 +794,19 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         }
         else
         {
-            int32_t value = 4 << 16; // 4 is a good IHOLDDELAY value for most cases, this will do a
-            // smooth transition from move to idle current
-            value |= (CalculateDigitalCurrent(
+            // 4 is a good IHOLDDELAY value for most cases, this will do a smooth transition from move to idle current
+            constexpr int32_t holdDelay = 4;
+            static_assert(TMC5130Fields::IHOLDDELAY.FitsValue(holdDelay));
+            SetField(TMC5130Fields::IHOLDDELAY, holdDelay);
+            SetField(TMC5130Fields::IRUN, CalculateDigitalCurrent(
                 static_cast<uint16_t>(current.milliamperes()),
                 SenseResistor.ohms(),
-                Vfs) << 8);
-            value |= CalculateDigitalCurrent(
+                Vfs));
+            SetField(TMC5130Fields::IHOLD, CalculateDigitalCurrent(
                 static_cast<uint16_t>(MotorIdleCurrent.milliamperes()),
                 SenseResistor.ohms(),
-                Vfs);
-            _writeInt(TMC5130_IHOLD_IRUN, value);
+                Vfs));
+            CommitFields();
         }
         return true;
     }
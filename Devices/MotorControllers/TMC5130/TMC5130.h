@@ -7,11 +7,13 @@
 #include "../../../Base/LLE_DAC.h"
 #include "LLE_SPI.h"
 #include "TMC5130_Config.h"
+#include "TMC5130_FieldAccess.h"
 #include <Duration.hpp>
 #include <ElectricCurrent.hpp>
 #include <ElectricResistance.hpp>
 #include <Frequency.hpp>
 #include <RotationalSpeed.hpp>
+#include <atomic>
 #include <functional>
 
 namespace LowLevelEmbedded::Devices::MotorControllers
@@ -35,6 +37,8 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         irNone, irStopped, irStalled
     } MotorIntReason_t;
 
+    constexpr size_t MOTOR_STATE_COUNT = msTimedConstantVelocityRampUp + 1;
+
     class TMC5130
     {
     public:
@@ -247,12 +251,80 @@ namespace LowLevelEmbedded::Devices::MotorControllers
         // Initialize a TMC5130 IC.
         // This function requires:
         //     - registerResetState: An int32_t array with 128 elements. This holds
-        //     the values to be used for a reset.
+        //     the values to be used for a reset. The array is not copied, it must
+        //     outlive the motor; declare it static const so it stays in flash.
         void Init(const int32_t* registerResetState);
 
         // Reset the TMC5130.
         bool Reset();
 
+        /**
+         * Writes the shadow registers back to the TMC5130, e.g. after the driver lost its supply.
+         * Only registers whose value differs from their power-on value are written, PeriodicJob sends them in
+         * bursts of the configuration write budget.
+         *
+         * @return false if a reset or restore is already in progress.
+         */
+        bool Restore();
+
+        /**
+         * Sets the number of registers PeriodicJob writes per call during a reset or restore.
+         * The default writes the whole configuration in one call.
+         */
+        void SetConfigurationWriteBudget(uint8_t registersPerCall);
+
+        /// When true, PeriodicJob starts a Restore as soon as the SPI status reports a driver reset
+        bool AutoRestore = false;
+
+        /// Poll interval that disables polling for a motor state, see SetPollInterval
+        static constexpr uint16_t POLL_NEVER = 0xFFFF;
+
+        /**
+         * @brief Switches PeriodicJob from reading the status every call to reading it on DIAG events.
+         *
+         * DIAG0 is the interrupt output of the ramp generator (position reached, stop switch and stallGuard
+         * stop events), DIAG1 signals a stall. Connect either or both to an external interrupt that calls
+         * OnDiagInterrupt. Between events the status is only read at the poll interval of the motor state,
+         * the defaults never poll msIdle and msConstantVelocity, so an idle motor costs no bus time.
+         * msTrajectory is polled every 100 ms, so LastKnownPosition is stale in between; code that follows the
+         * position during a move (like TMC5130MotionQueue) must lower that interval while it runs.
+         * Note that AutoRestore can only notice a driver reset when the status is read.
+         *
+         * @param pushPull true for push-pull DIAG outputs, false for open drain (external pull-up).
+         */
+        void EnableEventMode(bool pushPull = true);
+
+        /// Returns PeriodicJob to reading the status every call, the DIAG configuration is left as is.
+        void DisableEventMode();
+
+        /**
+         * True when the status has to be read now: always outside event mode, in event mode when a DIAG event
+         * is pending or the poll interval of the motor state has elapsed. A true result counts as the poll (the
+         * event is cleared and the interval restarts), so read the status and call ProcessStatus after it.
+         *
+         * @param elapsedTime As passed to PeriodicJob.
+         */
+        bool IsStatusDue(unitsnet_cpp::Duration elapsedTime);
+
+        /// Interrupt handler for the DIAG pins, only flags the event for the next PeriodicJob.
+        void OnDiagInterrupt();
+
+        /**
+         * Sets how often PeriodicJob reads the status in a motor state while event mode is active.
+         * @param intervalInms 0 reads every call, POLL_NEVER only reads on DIAG events
+         */
+        void SetPollInterval(MotorState_t state, uint16_t intervalInms);
+
+        /// The poll interval of a motor state in event mode, see SetPollInterval.
+        uint16_t GetPollInterval(MotorState_t state) const;
+
+        /// Reads XACTUAL from the driver and updates LastKnownPosition.
+        int32_t ReadActualPosition();
+
+        /// Redefines the actual position of a motor at standstill (e.g. after homing), XTARGET follows so the
+        /// motor does not move.
+        void SetActualPosition(int32_t position);
+
         /**
          * Performs periodic maintenance and control updates for the TMC5130 motor
          * driver. This function must be called regularly to handle tasks such as
@@ -263,6 +335,58 @@ namespace LowLevelEmbedded::Devices::MotorControllers
          */
         void PeriodicJob(unitsnet_cpp::Duration elapsedTime);
 
+        /**
+         * Runs the state handling of PeriodicJob on status values that were read elsewhere, e.g. by a
+         * TMC5130DaisyChain that reads all motors of a chain at once.
+         *
+         * @param xactual The XACTUAL register value.
+         * @param rampstatus The RAMPSTAT register value.
+         * @param elapsedTime As passed to PeriodicJob.
+         */
+        void ProcessStatus(int32_t xactual, int32_t rampstatus, unitsnet_cpp::Duration elapsedTime);
+
+        /// True while a reset or restore still has registers to write, PeriodicJob then writes those instead
+        /// of reading the status.
+        bool IsConfigurationPending() const;
+
+        /**
+         * Reads several registers in one pipelined sequence.
+         *
+         * The TMC5130 answers a read request with the next datagram, so every datagram requests the next register
+         * while it returns the previous one: N registers cost N + 1 transfers instead of 2 * N.
+         * Registers that cannot be read are returned from the shadow registers without bus access.
+         *
+         * @param addresses The register addresses to read.
+         * @param values Receives the register values, in the order of addresses.
+         * @param count The number of registers.
+         */
+        void ReadRegisters(const uint8_t* addresses, int32_t* values, size_t count);
+
+        /**
+         * Returns the SPI_STATUS byte of the last datagram exchanged with the TMC5130 (see TMC5130_SPI_STATUS_*).
+         * It is updated by every register access, so it is available without extra bus traffic.
+         */
+        uint8_t GetSPIStatus() const;
+
+        /**
+         * Reads a register field. Registers this driver has written, and registers that cannot be read back,
+         * are taken from the shadow register; all others are read from the chip.
+         */
+        int32_t ReadField(const TMC5130Field& field);
+
+        /**
+         * Changes a field in the shadow register without sending it. All fields changed in the same register
+         * go out as one datagram on CommitFields, a field that already holds the value causes no write.
+         * A register that was never written is read from the chip once to get the other fields.
+         */
+        void SetField(const TMC5130Field& field, int32_t value);
+
+        /// Writes every register changed by SetField since the last commit, one datagram per register.
+        void CommitFields();
+
+        /// SetField followed by CommitFields.
+        void WriteField(const TMC5130Field& field, int32_t value);
+
         /**
          * Initiates a timed movement in constant velocity mode for the TMC5130 motor
          * driver with specified acceleration, velocity, and duration. This function
@@ -332,7 +456,9 @@ namespace LowLevelEmbedded::Devices::MotorControllers
 
         /**
          * Stops the motor movement gradually by applying the specified deceleration.
-         * This function ensures the motor comes to a controlled stop.
+         * This function ensures the motor comes to a controlled stop. A positioning
+         * move is stopped too: the driver is switched to velocity mode, so the
+         * deceleration is used instead of DMAX and the old target is abandoned.
          *
          * @param dec The deceleration value to apply, which determines how quickly
          * the movement slows down.
@@ -360,23 +486,53 @@ namespace LowLevelEmbedded::Devices::MotorControllers
             unitsnet_cpp::Frequency maximumStepFrequency,
             int32_t decelerationInPulsesPerSecondSquared);
 
+        /**
+         * @brief Starts a positioning move, or changes the target of the running one, with ramp values that are
+         * already in motor units (see SpeedPPSToMotorUnits and AccDecPPSToMotorUnits).
+         *
+         * Ramp registers that already hold the value are not written again. When a move is running the ramp
+         * generator continues from the actual velocity, so the motor does not stop at the old target. XTARGET is
+         * written before the ramp, so a target left behind by StopMovement is never approached.
+         */
+        void MoveToPositionInMotorUnits(int32_t position, int32_t vmax, int32_t amax, int32_t dmax);
+
+        /// The first half of MoveToPositionInMotorUnits: selects positioning mode, the move current and the ramp.
+        void SetPositioningRamp(int32_t vmax, int32_t amax, int32_t dmax);
+
+        /// The second half of MoveToPositionInMotorUnits: writes XTARGET, which starts the move.
+        void SetTargetPosition(int32_t position);
+
     private:
         ISPIAccess* _SPIAccess;
         uint8_t _stopSwitchID;
         bool _stopSwitchInverted;
         int32_t _lastStartTimeInms;
         int32_t _targetMoveTimeInms;
-        int32_t _registerResetState[TMC5130_REGISTER_COUNT] = {};
-        uint8_t _registerAccess[TMC5130_REGISTER_COUNT] = {};
-        int32_t _shadowRegister[TMC5130_REGISTER_COUNT] = {};
+        const int32_t* _registerResetState = nullptr;
+        int32_t _shadowRegister[TMC5130_SHADOW_REGISTER_COUNT] = {}; // writable registers only, see _shadow
+        uint32_t _dirtyRegisters[TMC5130_REGISTER_COUNT / 32] = {}; // written since the last reset
         ConfigState _configState = CONFIG_READY;
+        uint8_t _spiStatus = 0;
         uint8_t _configIndex = 0;
+        uint8_t _configWriteBudget = TMC5130_REGISTER_COUNT;
+        uint8_t _configWrites = 0;
+        bool _eventMode = false;
+        std::atomic<bool> _diagEvent {false};
+        int32_t _lastPollTimeInms = 0;
+        uint16_t _pollIntervalInms[MOTOR_STATE_COUNT] = {};
+        uint32_t _pendingFieldWrites[TMC5130_REGISTER_COUNT / 32] = {}; // registers changed by SetField
         // uint8_t (*_resetCallback)(void) = nullptr;
         // uint8_t (*_restoreCallback)(void) = nullptr;
 
         void _writeDatagram(uint8_t address, uint8_t x1, uint8_t x2, uint8_t x3, uint8_t x4);
         void _writeInt(uint8_t address, int32_t value);
-        int32_t _readInt(uint8_t address) const;
+        void _writeIntIfChanged(uint8_t address, int32_t value);
+        int32_t _readDatagram(uint8_t address);
+        int32_t _readInt(uint8_t address);
+        bool _isShadowValid(uint8_t address) const;
+        bool _isDirty(uint8_t address) const;
+        int32_t _shadow(uint8_t address) const;
+        void _setShadow(uint8_t address, int32_t value);
         void _writeConfiguration();
         void _activateMoveCurrent();
         void _activateRampUpCurrent();
@@ -0,0 +1,165 @@
+#include "TMC5130Coordinator.h"
+#include "TMC5130_Utils.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <ulog.h>
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    TMC5130Coordinator::TMC5130Coordinator(TMC5130* const* axes, const uint8_t axisCount, TMC5130DaisyChain* chain)
+    {
+        this->_axisCount = (axisCount > TMC5130_COORDINATOR_MAX_AXES) ? TMC5130_COORDINATOR_MAX_AXES : axisCount;
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            this->_axes[axis] = axes[axis];
+        }
+        this->_chain = chain;
+    }
+
+    uint8_t TMC5130Coordinator::AxisCount() const
+    {
+        return this->_axisCount;
+    }
+
+    bool TMC5130Coordinator::IsMoving() const
+    {
+        return this->_moving;
+    }
+
+    void TMC5130Coordinator::_beginBatch()
+    {
+        if (this->_chain != nullptr) this->_chain->BeginBatch();
+    }
+
+    void TMC5130Coordinator::_endBatch()
+    {
+        if (this->_chain != nullptr) this->_chain->EndBatch();
+    }
+
+    bool TMC5130Coordinator::MoveTo(const int32_t* targets, const int32_t accelerationInPulsesPerSecondSquared,
+                                    unitsnet_cpp::Frequency maximumStepFrequency)
+    {
+        const float velocity = std::fabs(maximumStepFrequency.hertz());
+        if ((accelerationInPulsesPerSecondSquared <= 0) || (velocity <= 0.0f))
+        {
+            return false;
+        }
+
+        int32_t longest = 0;
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            if (this->_axes[axis]->IsConfigurationPending()) return false;
+            const int32_t distance = std::abs(targets[axis] - this->_axes[axis]->LastKnownPosition);
+            if (distance > longest) longest = distance;
+        }
+        if (longest == 0)
+        {
+            return true;
+        }
+
+        log_info("TMC5130 group: Coordinated move of %d axes over %ld steps", this->_axisCount, longest);
+
+        // Ramps first with VMAX = 0: XTARGET may still hold an old target (after a velocity move or a stop), so an
+        // axis would start towards it as soon as it is in positioning mode with a velocity
+        int32_t vmax[TMC5130_COORDINATOR_MAX_AXES] = {};
+        _beginBatch();
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            TMC5130* motor = this->_axes[axis];
+            const int32_t distance = std::abs(targets[axis] - motor->LastKnownPosition);
+            if (distance == 0) continue;
+
+            const float scale = static_cast<float>(distance) / static_cast<float>(longest);
+            vmax[axis] = SpeedPPSToMotorUnits(static_cast<int32_t>(std::lround(velocity * scale)));
+            int32_t amax = AccDecPPSToMotorUnits(
+                static_cast<int32_t>(std::lround(static_cast<float>(accelerationInPulsesPerSecondSquared) * scale)));
+            if (vmax[axis] < 1) vmax[axis] = 1;
+            if (amax < 1) amax = 1;
+
+            // V1 = 0 disables the A1/D1 phase, so every axis runs a plain trapezoid that scales with distance.
+            // A move that replaces a running one keeps the V1 saved by the first.
+            if (!this->_v1Overridden[axis])
+            {
+                this->_savedV1[axis] = motor->ReadField(TMC5130Fields::V1);
+                this->_v1Overridden[axis] = true;
+            }
+            motor->WriteField(TMC5130Fields::V1, 0);
+            motor->WriteField(TMC5130Fields::VMAX, 0);
+            motor->SetPositioningRamp(0, amax, amax);
+        }
+        _endBatch();
+
+        // Targets, then the velocities that start the axes, back to back: on a daisy chain the XTARGETs go out in
+        // one frame and the VMAXs in the next
+        _beginBatch();
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            if (vmax[axis] == 0) continue;
+            this->_axes[axis]->SetTargetPosition(targets[axis]);
+        }
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            if (vmax[axis] == 0) continue;
+            this->_axes[axis]->WriteField(TMC5130Fields::VMAX, vmax[axis]);
+        }
+        _endBatch();
+
+        this->_moving = true;
+        return true;
+    }
+
+    void TMC5130Coordinator::_restoreV1()
+    {
+        _beginBatch();
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            if (!this->_v1Overridden[axis]) continue;
+            this->_axes[axis]->WriteField(TMC5130Fields::V1, this->_savedV1[axis]);
+            this->_v1Overridden[axis] = false;
+        }
+        _endBatch();
+    }
+
+    void TMC5130Coordinator::Stop(const int32_t decelerationInPulsesPerSecondSquared)
+    {
+        _beginBatch();
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            this->_axes[axis]->StopMovement(decelerationInPulsesPerSecondSquared);
+        }
+        _endBatch();
+    }
+
+    void TMC5130Coordinator::PeriodicJob(unitsnet_cpp::Duration elapsedTime)
+    {
+        if (this->_chain != nullptr)
+        {
+            this->_chain->PeriodicJob(elapsedTime);
+        }
+        else
+        {
+            for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+            {
+                this->_axes[axis]->PeriodicJob(elapsedTime);
+            }
+        }
+
+        if (!this->_moving)
+        {
+            return;
+        }
+        for (uint8_t axis = 0; axis < this->_axisCount; axis++)
+        {
+            const MotorState_t state = this->_axes[axis]->MotorState;
+            if ((state != msIdle) && (state != msStopped)) return;
+        }
+
+        this->_moving = false;
+        _restoreV1();
+        if (this->MoveCompletedCallback) // check if callback was assigned
+        {
+            this->MoveCompletedCallback(*this);
+        }
+    }
+} // namespace LowLevelEmbedded::Devices::MotorControllers
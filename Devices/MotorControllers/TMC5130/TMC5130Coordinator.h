@@ -0,0 +1,77 @@
+#pragma once
+
+#include "TMC5130.h"
+#include "TMC5130DaisyChain.h"
+#include <Duration.hpp>
+#include <Frequency.hpp>
+#include <functional>
+
+// Maximum number of axes in one coordinated group
+#ifndef TMC5130_COORDINATOR_MAX_AXES
+#define TMC5130_COORDINATOR_MAX_AXES 6
+#endif
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    /**
+     * @class TMC5130Coordinator
+     * @brief Moves a group of TMC5130 axes along a straight line, so all axes start and arrive together.
+     *
+     * The axis with the longest distance runs at the given velocity and acceleration, the others get VMAX,
+     * AMAX and DMAX scaled by their share of that distance. With V1 = 0 every axis runs a trapezoid of the same
+     * duration. The ramps of all axes are written first with VMAX = 0, then the XTARGETs and last the VMAXs that
+     * start the axes, back to back; when the axes share a TMC5130DaisyChain the VMAXs go out in one frame.
+     *
+     * MoveTo leaves VMAX, AMAX and DMAX of the axes at the scaled values. The V1 of every moved axis is restored
+     * by PeriodicJob once all axes have stopped, before MoveCompletedCallback.
+     *
+     * PeriodicJob replaces the PeriodicJob calls of the individual axes (or of their chain).
+     */
+    class TMC5130Coordinator
+    {
+    public:
+        /**
+         * @param axes The motors of the group, at most TMC5130_COORDINATOR_MAX_AXES.
+         * @param axisCount The number of motors in axes.
+         * @param chain The daisy chain the axes are attached to, nullptr when every axis has its own chip select.
+         */
+        TMC5130Coordinator(TMC5130* const* axes, uint8_t axisCount, TMC5130DaisyChain* chain = nullptr);
+
+        /**
+         * Starts a coordinated move of all axes.
+         *
+         * @param targets One target position per axis.
+         * @param accelerationInPulsesPerSecondSquared Acceleration and deceleration of the longest axis.
+         * @param maximumStepFrequency The velocity of the longest axis.
+         * @return false if an axis is still writing its configuration or the ramp values are not positive
+         */
+        bool MoveTo(const int32_t* targets, int32_t accelerationInPulsesPerSecondSquared,
+                    unitsnet_cpp::Frequency maximumStepFrequency);
+
+        /// Ramps all axes down with the given deceleration.
+        void Stop(int32_t decelerationInPulsesPerSecondSquared);
+
+        /// Updates all axes and calls MoveCompletedCallback when the last axis has reached its target.
+        void PeriodicJob(unitsnet_cpp::Duration elapsedTime);
+
+        /// True while at least one axis of the last MoveTo is still moving.
+        bool IsMoving() const;
+
+        uint8_t AxisCount() const;
+
+        /// Called from PeriodicJob when all axes of a coordinated move have stopped.
+        std::function<void(TMC5130Coordinator&)> MoveCompletedCallback;
+
+    private:
+        TMC5130* _axes[TMC5130_COORDINATOR_MAX_AXES] = {};
+        uint8_t _axisCount;
+        TMC5130DaisyChain* _chain;
+        bool _moving = false;
+        int32_t _savedV1[TMC5130_COORDINATOR_MAX_AXES] = {};
+        bool _v1Overridden[TMC5130_COORDINATOR_MAX_AXES] = {};
+
+        void _beginBatch();
+        void _endBatch();
+        void _restoreV1();
+    };
+} // namespace LowLevelEmbedded::Devices::MotorControllers
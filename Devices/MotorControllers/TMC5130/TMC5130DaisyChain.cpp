@@ -0,0 +1,205 @@
+#include "TMC5130DaisyChain.h"
+#include "TMC5130_Register.h"
+
+#include <cstring>
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    TMC5130DaisyChain::TMC5130DaisyChain(ISPIAccess* spiAccess, const uint8_t chipSelectID, const uint8_t length)
+    {
+        this->_spiAccess = spiAccess;
+        this->_chipSelectID = chipSelectID;
+        this->_length = (length > TMC5130_DAISY_CHAIN_MAX_LENGTH) ? TMC5130_DAISY_CHAIN_MAX_LENGTH : length;
+    }
+
+    bool TMC5130DaisyChain::Attach(const uint8_t position, TMC5130* motor)
+    {
+        if (position >= this->_length) return false;
+        this->_motors[position] = motor;
+        motor->ChipID = position;
+        return true;
+    }
+
+    uint8_t TMC5130DaisyChain::Length() const
+    {
+        return this->_length;
+    }
+
+    uint8_t TMC5130DaisyChain::GetSPIStatus(const uint8_t position) const
+    {
+        return (position < this->_length) ? this->_spiStatus[position] : 0;
+    }
+
+    // The first datagram shifted out ends up in the last driver of the chain, and the last driver's reply is
+    // the first one shifted in, so a position maps to the same frame offset for sending and receiving
+    uint8_t* TMC5130DaisyChain::_datagram(const uint8_t position)
+    {
+        return &this->_frame[(this->_length - 1 - position) * DATAGRAM_SIZE];
+    }
+
+    // Positions that are not selected read GCONF, which has no read side effects
+    void TMC5130DaisyChain::_fillWithReadRequests(const uint8_t address, const bool* selected)
+    {
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            uint8_t* datagram = _datagram(position);
+            datagram[0] = ((selected == nullptr) || selected[position]) ? address : TMC5130_GCONF;
+            datagram[1] = datagram[2] = datagram[3] = datagram[4] = 0;
+        }
+    }
+
+    void TMC5130DaisyChain::_transferFrame()
+    {
+        this->_spiAccess->ReadWriteSPI(&this->_frame[0], this->_length * DATAGRAM_SIZE, this->_chipSelectID,
+                                       SPIMode::Mode3);
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            this->_spiStatus[position] = _datagram(position)[0];
+        }
+    }
+
+    int32_t TMC5130DaisyChain::_datagramValue(const uint8_t* datagram)
+    {
+        return (datagram[1] << 24) | (datagram[2] << 16) | (datagram[3] << 8) | datagram[4];
+    }
+
+    void TMC5130DaisyChain::BeginBatch()
+    {
+        this->_batching = true;
+    }
+
+    void TMC5130DaisyChain::Flush()
+    {
+        uint8_t depth = 0;
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            if (this->_queued[position] > depth) depth = this->_queued[position];
+        }
+
+        // Frame n carries the n-th queued datagram of every motor, motors with fewer get a harmless read
+        for (uint8_t n = 0; n < depth; n++)
+        {
+            _fillWithReadRequests(TMC5130_GCONF);
+            for (uint8_t position = 0; position < this->_length; position++)
+            {
+                if (n < this->_queued[position])
+                {
+                    std::memcpy(_datagram(position), this->_queue[position][n], DATAGRAM_SIZE);
+                }
+            }
+            _transferFrame();
+        }
+
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            this->_queued[position] = 0;
+        }
+    }
+
+    void TMC5130DaisyChain::EndBatch()
+    {
+        Flush();
+        this->_batching = false;
+    }
+
+    void TMC5130DaisyChain::ReadWriteSPI(uint8_t* data, size_t length, const uint8_t cs_ID, enum SPIMode mode)
+    {
+        (void)mode;
+        if ((cs_ID >= this->_length) || (length != DATAGRAM_SIZE)) return;
+
+        const bool isWrite = (data[0] & TMC5130_WRITE_BIT) != 0;
+        if (this->_batching && isWrite)
+        {
+            if (this->_queued[cs_ID] == TMC5130_DAISY_CHAIN_QUEUE_DEPTH)
+            {
+                Flush();
+            }
+            std::memcpy(this->_queue[cs_ID][this->_queued[cs_ID]++], data, DATAGRAM_SIZE);
+            // The reply to a write is not used, report the last known status
+            data[0] = this->_spiStatus[cs_ID];
+            data[1] = data[2] = data[3] = data[4] = 0;
+            return;
+        }
+
+        // Queued writes go first so the registers change in the order they were written
+        Flush();
+        _fillWithReadRequests(TMC5130_GCONF);
+        std::memcpy(_datagram(cs_ID), data, DATAGRAM_SIZE);
+        _transferFrame();
+        std::memcpy(data, _datagram(cs_ID), DATAGRAM_SIZE);
+    }
+
+    void TMC5130DaisyChain::WriteSPI(uint8_t* data, size_t length, const uint8_t cs_ID, enum SPIMode mode)
+    {
+        ReadWriteSPI(data, length, cs_ID, mode);
+    }
+
+    void TMC5130DaisyChain::WriteThenReadSPI(uint8_t* writedata, size_t writelength, uint8_t* readdata,
+                                             size_t readlength, const uint8_t cs_ID, enum SPIMode mode)
+    {
+        uint8_t datagram[DATAGRAM_SIZE] = {0, 0, 0, 0, 0};
+        std::memcpy(datagram, writedata, (writelength < DATAGRAM_SIZE) ? writelength : DATAGRAM_SIZE);
+        ReadWriteSPI(datagram, DATAGRAM_SIZE, cs_ID, mode);
+        std::memcpy(readdata, datagram, (readlength < DATAGRAM_SIZE) ? readlength : DATAGRAM_SIZE);
+    }
+
+    void TMC5130DaisyChain::PeriodicJob(unitsnet_cpp::Duration elapsedTime)
+    {
+        // Motors that reset or restore their configuration share frames as well
+        bool due[TMC5130_DAISY_CHAIN_MAX_LENGTH] = {};
+        bool anyDue = false;
+        BeginBatch();
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            TMC5130* motor = this->_motors[position];
+            if (motor == nullptr) continue;
+            if (motor->IsConfigurationPending())
+            {
+                motor->PeriodicJob(elapsedTime);
+            }
+            else
+            {
+                due[position] = motor->IsStatusDue(elapsedTime);
+                anyDue = anyDue || due[position];
+            }
+        }
+        EndBatch();
+        if (!anyDue) return;
+
+        // Pipelined for the whole chain: request XACTUAL, request RAMPSTAT (returns XACTUAL),
+        // request GCONF (returns RAMPSTAT)
+        Flush();
+        int32_t xactual[TMC5130_DAISY_CHAIN_MAX_LENGTH];
+        int32_t rampstatus[TMC5130_DAISY_CHAIN_MAX_LENGTH];
+        // Only the motors that are due read RAMPSTAT, reading it clears its event flags
+        _fillWithReadRequests(TMC5130_XACTUAL, due);
+        _transferFrame();
+        _fillWithReadRequests(TMC5130_RAMPSTAT, due);
+        _transferFrame();
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            xactual[position] = _datagramValue(_datagram(position));
+        }
+        _fillWithReadRequests(TMC5130_GCONF);
+        _transferFrame();
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            rampstatus[position] = _datagramValue(_datagram(position));
+        }
+
+        // The reactions of all motors (e.g. current changes) go out together
+        BeginBatch();
+        for (uint8_t position = 0; position < this->_length; position++)
+        {
+            TMC5130* motor = this->_motors[position];
+            if ((motor == nullptr) || !due[position]) continue;
+            if (motor->AutoRestore && ((this->_spiStatus[position] & TMC5130_SPI_STATUS_RESET_FLAG) != 0))
+            {
+                motor->Restore();
+                continue;
+            }
+            motor->ProcessStatus(xactual[position], rampstatus[position], elapsedTime);
+        }
+        EndBatch();
+    }
+} // namespace LowLevelEmbedded::Devices::MotorControllers
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "LLE_SPI.h"
+#include "TMC5130.h"
+#include <Duration.hpp>
+
+// Maximum number of TMC5130s in one chain, sets the size of the frame buffers
+#ifndef TMC5130_DAISY_CHAIN_MAX_LENGTH
+#define TMC5130_DAISY_CHAIN_MAX_LENGTH 12
+#endif
+
+// Number of write datagrams that can be queued per motor before the queue is flushed automatically
+#ifndef TMC5130_DAISY_CHAIN_QUEUE_DEPTH
+#define TMC5130_DAISY_CHAIN_QUEUE_DEPTH 4
+#endif
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    /**
+     * @class TMC5130DaisyChain
+     * @brief Drives up to TMC5130_DAISY_CHAIN_MAX_LENGTH daisy-chained TMC5130s on one chip select.
+     *
+     * The chain is the ISPIAccess of its motors: construct every TMC5130 with the chain and attach it at its
+     * position (this sets its ChipID to the position). Position 0 is the driver whose SDI is connected to the
+     * MCU, every transfer is one frame of 40 bits per driver, drivers without a datagram get a GCONF read.
+     *
+     * Between BeginBatch and EndBatch the write datagrams of all motors are queued and sent together, one
+     * datagram per motor per frame. A read request flushes the queue first, so reads stay in order.
+     * PeriodicJob reads XACTUAL and RAMPSTAT of the motors whose status is due (see TMC5130::IsStatusDue) in three
+     * frames and runs their state handling with the writes batched. When no motor is due, e.g. all idle motors in
+     * event mode, no frame is sent.
+     */
+    class TMC5130DaisyChain : public ISPIAccess
+    {
+    public:
+        static constexpr size_t DATAGRAM_SIZE = 5;
+
+        /**
+         * @param spiAccess The bus the chain is connected to.
+         * @param chipSelectID The chip select shared by all drivers of the chain.
+         * @param length The number of drivers in the chain (at most TMC5130_DAISY_CHAIN_MAX_LENGTH).
+         */
+        TMC5130DaisyChain(ISPIAccess* spiAccess, uint8_t chipSelectID, uint8_t length);
+
+        /// Registers the motor at a chain position and sets its ChipID to that position.
+        /// \return false if the position is outside the chain
+        bool Attach(uint8_t position, TMC5130* motor);
+
+        uint8_t Length() const;
+
+        /// The SPI_STATUS byte last returned by the driver at a position
+        uint8_t GetSPIStatus(uint8_t position) const;
+
+        /// Starts queueing write datagrams instead of sending them one frame each.
+        void BeginBatch();
+
+        /// Sends all queued write datagrams, the batch stays open.
+        void Flush();
+
+        /// Sends all queued write datagrams and returns to sending every datagram immediately.
+        void EndBatch();
+
+        /**
+         * Updates all attached motors. Motors that are still writing their configuration run their own
+         * PeriodicJob, the ones whose status is due are read together and handled with their writes batched.
+         */
+        void PeriodicJob(unitsnet_cpp::Duration elapsedTime);
+
+        // ISPIAccess, used by the attached motors: cs_ID is the chain position, one datagram per call
+        void WriteSPI(uint8_t* data, size_t length, uint8_t cs_ID, enum SPIMode mode) override;
+        void ReadWriteSPI(uint8_t* data, size_t length, uint8_t cs_ID, enum SPIMode mode) override;
+        void WriteThenReadSPI(uint8_t* writedata, size_t writelength, uint8_t* readdata, size_t readlength,
+                              uint8_t cs_ID, enum SPIMode mode) override;
+
+    private:
+        ISPIAccess* _spiAccess;
+        uint8_t _chipSelectID;
+        uint8_t _length;
+        bool _batching = false;
+        TMC5130* _motors[TMC5130_DAISY_CHAIN_MAX_LENGTH] = {};
+        uint8_t _spiStatus[TMC5130_DAISY_CHAIN_MAX_LENGTH] = {};
+        uint8_t _queue[TMC5130_DAISY_CHAIN_MAX_LENGTH][TMC5130_DAISY_CHAIN_QUEUE_DEPTH][DATAGRAM_SIZE] = {};
+        uint8_t _queued[TMC5130_DAISY_CHAIN_MAX_LENGTH] = {};
+        uint8_t _frame[TMC5130_DAISY_CHAIN_MAX_LENGTH * DATAGRAM_SIZE] = {};
+
+        uint8_t* _datagram(uint8_t position);
+        void _fillWithReadRequests(uint8_t address, const bool* selected = nullptr);
+        void _transferFrame();
+        static int32_t _datagramValue(const uint8_t* datagram);
+    };
+} // namespace LowLevelEmbedded::Devices::MotorControllers
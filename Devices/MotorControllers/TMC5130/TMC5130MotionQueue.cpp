@@ -0,0 +1,134 @@
+#include "TMC5130MotionQueue.h"
+#include "TMC5130_Utils.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <ulog.h>
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    TMC5130MotionQueue::TMC5130MotionQueue(TMC5130* motor)
+    {
+        this->_motor = motor;
+    }
+
+    bool TMC5130MotionQueue::Add(const int32_t position, const int32_t accelerationInPulsesPerSecondSquared,
+                                 unitsnet_cpp::Frequency maximumStepFrequency)
+    {
+        const float velocity = std::fabs(maximumStepFrequency.hertz());
+        if ((accelerationInPulsesPerSecondSquared <= 0) || (velocity <= 0.0f))
+        {
+            return false;
+        }
+
+        TMC5130MotionSegment segment;
+        segment.Position = position;
+        segment.VMax = SpeedPPSToMotorUnits(static_cast<int32_t>(velocity));
+        segment.AMax = AccDecPPSToMotorUnits(accelerationInPulsesPerSecondSquared);
+        segment.Velocity = velocity;
+        segment.PreloadDistance = (velocity * velocity) / (2.0f * static_cast<float>(accelerationInPulsesPerSecondSquared));
+        return this->_segments.Push(segment);
+    }
+
+    bool TMC5130MotionQueue::Start()
+    {
+        if (this->_running)
+        {
+            return false;
+        }
+        TMC5130MotionSegment segment;
+        if (!this->_segments.Pop(segment))
+        {
+            return false;
+        }
+        log_info("TMC5130 #%d: Starting motion queue with %d segments", this->_motor->ChipID,
+                 static_cast<int>(this->_segments.Count() + 1));
+        this->_segmentStart = this->_motor->LastKnownPosition;
+        this->_running = true;
+        // Update needs a fresh position on every call
+        this->_savedPollInterval = this->_motor->GetPollInterval(msTrajectory);
+        this->_motor->SetPollInterval(msTrajectory, 0);
+        _load(segment);
+        return true;
+    }
+
+    void TMC5130MotionQueue::Cancel(const int32_t decelerationInPulsesPerSecondSquared)
+    {
+        this->_segments.Clear();
+        if (this->_running)
+        {
+            _finish();
+            this->_motor->StopMovement(decelerationInPulsesPerSecondSquared);
+        }
+    }
+
+    void TMC5130MotionQueue::_finish()
+    {
+        this->_running = false;
+        this->_motor->SetPollInterval(msTrajectory, this->_savedPollInterval);
+    }
+
+    void TMC5130MotionQueue::_load(const TMC5130MotionSegment& segment)
+    {
+        this->_motor->MoveToPositionInMotorUnits(segment.Position, segment.VMax, segment.AMax, segment.AMax);
+        this->_current = segment;
+    }
+
+    void TMC5130MotionQueue::Update(unitsnet_cpp::Duration timeSinceLastUpdate)
+    {
+        if (!this->_running)
+        {
+            return;
+        }
+
+        TMC5130MotionSegment next;
+        const bool hasNext = this->_segments.Peek(next);
+
+        if (this->_motor->MotorState != msTrajectory)
+        {
+            // The segment reached its position (or the motor was stopped from elsewhere)
+            if (!hasNext || (this->_motor->MotorState != msStopped))
+            {
+                _finish();
+                this->_segments.Clear();
+                return;
+            }
+            this->_segments.Pop(next);
+            this->_segmentStart = this->_current.Position;
+            _load(next);
+            return;
+        }
+
+        if (!hasNext)
+        {
+            return;
+        }
+
+        // Only continue without stopping when the next segment goes on in the same direction
+        const int32_t direction = this->_current.Position - this->_segmentStart;
+        const int32_t nextDirection = next.Position - this->_current.Position;
+        if ((direction >= 0) != (nextDirection >= 0))
+        {
+            return;
+        }
+
+        const float tickDistance = this->_current.Velocity * static_cast<float>(timeSinceLastUpdate.seconds());
+        const float remaining = static_cast<float>(std::abs(this->_current.Position - this->_motor->LastKnownPosition));
+        if (remaining <= (this->_current.PreloadDistance + tickDistance))
+        {
+            this->_segments.Pop(next);
+            this->_segmentStart = this->_current.Position;
+            _load(next);
+        }
+    }
+
+    bool TMC5130MotionQueue::IsRunning() const
+    {
+        return this->_running;
+    }
+
+    size_t TMC5130MotionQueue::QueuedSegments() const
+    {
+        return this->_segments.Count();
+    }
+} // namespace LowLevelEmbedded::Devices::MotorControllers
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "TMC5130.h"
+#include "../../../Utilities/LockFreeQueue.h"
+#include <Duration.hpp>
+#include <Frequency.hpp>
+
+// Number of segments that can be queued behind the running one, must be a power of two
+#ifndef TMC5130_MOTION_QUEUE_DEPTH
+#define TMC5130_MOTION_QUEUE_DEPTH 16
+#endif
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    /// One segment of a queued move, the ramp register values are calculated when the segment is added
+    struct TMC5130MotionSegment
+    {
+        int32_t Position;       // XTARGET
+        int32_t VMax;           // VMAX in motor units
+        int32_t AMax;           // AMAX and DMAX in motor units
+        float PreloadDistance;  // braking distance in steps from VMax
+        float Velocity;         // in steps per second
+    };
+
+    /**
+     * @class TMC5130MotionQueue
+     * @brief Runs a list of positioning segments on one TMC5130 without stopping between them.
+     *
+     * The ramp registers of a segment are calculated when it is added. While a segment runs, the next one is
+     * loaded as soon as the remaining distance is within the braking distance plus the distance of one update,
+     * the ramp generator then carries on into the next segment instead of ramping down to zero. A segment that
+     * reverses the direction is only started when the previous one has reached its position.
+     *
+     * Update does not talk to the driver itself, it works with the position read by the PeriodicJob of the
+     * motor (or of its TMC5130DaisyChain), so it must be called right after that. In event mode the motor only
+     * polls msTrajectory every 100 ms by default, so the queue sets that poll interval to 0 while it runs and
+     * restores it afterwards.
+     */
+    class TMC5130MotionQueue
+    {
+    public:
+        explicit TMC5130MotionQueue(TMC5130* motor);
+
+        /**
+         * Adds a segment to the end of the queue.
+         *
+         * @param position The target position in steps.
+         * @param accelerationInPulsesPerSecondSquared Acceleration and deceleration of the segment.
+         * @param maximumStepFrequency The velocity of the segment.
+         * @return false if the queue is full or the ramp values are not positive
+         */
+        bool Add(int32_t position, int32_t accelerationInPulsesPerSecondSquared,
+                 unitsnet_cpp::Frequency maximumStepFrequency);
+
+        /// Starts the first queued segment. \return false if the queue is empty or already running
+        bool Start();
+
+        /// Discards the queued segments and ramps the motor down with the given deceleration.
+        void Cancel(int32_t decelerationInPulsesPerSecondSquared);
+
+        /**
+         * Loads the next segment when the running one gets close to its position.
+         *
+         * @param timeSinceLastUpdate The time between two calls, used for the distance the motor travels
+         * before the next update.
+         */
+        void Update(unitsnet_cpp::Duration timeSinceLastUpdate);
+
+        /// True from Start until the last segment has reached its position (or the motor was stopped).
+        bool IsRunning() const;
+
+        /// Number of segments waiting behind the running one.
+        size_t QueuedSegments() const;
+
+    private:
+        TMC5130* _motor;
+        Utility::LockFreeQueue<TMC5130MotionSegment, TMC5130_MOTION_QUEUE_DEPTH> _segments;
+        TMC5130MotionSegment _current = {};
+        int32_t _segmentStart = 0;
+        bool _running = false;
+        uint16_t _savedPollInterval = 0;
+
+        void _load(const TMC5130MotionSegment& segment);
+        void _finish();
+    };
+} // namespace LowLevelEmbedded::Devices::MotorControllers
@@ -0,0 +1,264 @@
+#include "TMC5130StallGuard.h"
+#include "TMC5130_Register.h"
+#include "../../../Utilities/Delay.h"
+
+#include <cstdlib>
+#include <ulog.h>
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    TMC5130StallGuard::TMC5130StallGuard(TMC5130* motor)
+    {
+        this->_motor = motor;
+    }
+
+    void TMC5130StallGuard::Sample()
+    {
+        static constexpr uint8_t address = TMC5130_DRVSTATUS;
+        int32_t status;
+        this->_motor->ReadRegisters(&address, &status, 1);
+
+        TMC5130LoadSample sample;
+        sample.Time = Utility::timestamp ? Utility::timestamp() : 0;
+        sample.SGResult = static_cast<uint16_t>(TMC5130Fields::SG_RESULT.Get(status));
+        sample.CSActual = static_cast<uint8_t>(TMC5130Fields::CS_ACTUAL.Get(status));
+        sample.Stalled = TMC5130Fields::STALLGUARD.Get(status) != 0;
+        this->_lastSample = sample;
+        if (!this->_history.Push(sample))
+        {
+            this->_droppedSamples++;
+        }
+
+        if (this->_filterPrimed)
+        {
+            this->_filteredSGResult += this->_filterWeight * (static_cast<float>(sample.SGResult) - this->_filteredSGResult);
+        }
+        else
+        {
+            this->_filteredSGResult = static_cast<float>(sample.SGResult);
+            this->_filterPrimed = true;
+        }
+
+        if (this->_tuning)
+        {
+            _tuneStep();
+        }
+        if ((this->_homingState == hsAccelerating) || (this->_homingState == hsSearching) ||
+            (this->_homingState == hsStopping))
+        {
+            _homingStep();
+        }
+    }
+
+    bool TMC5130StallGuard::TryGetSample(TMC5130LoadSample& sample)
+    {
+        return this->_history.Pop(sample);
+    }
+
+    uint32_t TMC5130StallGuard::DroppedSamples() const
+    {
+        return this->_droppedSamples;
+    }
+
+    TMC5130LoadSample TMC5130StallGuard::LastSample() const
+    {
+        return this->_lastSample;
+    }
+
+    float TMC5130StallGuard::FilteredSGResult() const
+    {
+        return this->_filteredSGResult;
+    }
+
+    void TMC5130StallGuard::SetFilterWeight(const float weight)
+    {
+        this->_filterWeight = (weight <= 0.0f || weight > 1.0f) ? 1.0f : weight;
+    }
+
+    int8_t TMC5130StallGuard::SGT() const
+    {
+        return this->_sgt;
+    }
+
+    void TMC5130StallGuard::SetSGT(const int8_t sgt)
+    {
+        this->_sgt = sgt;
+        this->_motor->WriteField(TMC5130Fields::SGT, sgt);
+        // Readings taken with the old threshold say nothing about the new one
+        this->_filterPrimed = false;
+    }
+
+    bool TMC5130StallGuard::StartSGTTuning(const uint16_t targetResult, const uint16_t window, const uint8_t settleSamples)
+    {
+        if ((this->_motor->MotorState != msConstantVelocity) && (this->_motor->MotorState != msTimedConstantVelocity))
+        {
+            return false;
+        }
+        log_info("TMC5130 #%d: Tuning SGT for SG_RESULT %d +/- %d", this->_motor->ChipID, targetResult, window);
+        this->_sgt = static_cast<int8_t>(this->_motor->ReadField(TMC5130Fields::SGT));
+        this->_tuneTarget = targetResult;
+        this->_tuneWindow = window;
+        this->_tuneSettleSamples = (settleSamples == 0) ? 1 : settleSamples;
+        this->_tuneSampleCount = 0;
+        this->_tuneLastDirection = 0;
+        this->_filterPrimed = false;
+        this->_tuning = true;
+        return true;
+    }
+
+    bool TMC5130StallGuard::IsTuningSGT() const
+    {
+        return this->_tuning;
+    }
+
+    void TMC5130StallGuard::_tuneStep()
+    {
+        if ((this->_motor->MotorState != msConstantVelocity) && (this->_motor->MotorState != msTimedConstantVelocity))
+        {
+            log_warn("TMC5130 #%d: SGT tuning aborted, motor left constant velocity", this->_motor->ChipID);
+            this->_tuning = false;
+            return;
+        }
+        if (++this->_tuneSampleCount < this->_tuneSettleSamples)
+        {
+            return;
+        }
+        this->_tuneSampleCount = 0;
+
+        // A higher SGT makes stallGuard less sensitive and raises SG_RESULT
+        int8_t direction = 0;
+        if (this->_filteredSGResult < static_cast<float>(this->_tuneTarget - this->_tuneWindow)) direction = 1;
+        else if (this->_filteredSGResult > static_cast<float>(this->_tuneTarget + this->_tuneWindow)) direction = -1;
+
+        const int32_t sgt = this->_sgt + direction;
+        if ((direction == 0) || (direction == -this->_tuneLastDirection) ||
+            !TMC5130Fields::SGT.FitsValue(sgt))
+        {
+            // In the window, stepped over it, or out of range: keep the current value
+            log_info("TMC5130 #%d: SGT tuned to %d (SG_RESULT %d)", this->_motor->ChipID, this->_sgt,
+                     static_cast<int>(this->_filteredSGResult));
+            this->_tuning = false;
+            return;
+        }
+        this->_tuneLastDirection = direction;
+        SetSGT(static_cast<int8_t>(sgt));
+    }
+
+    bool TMC5130StallGuard::StartHoming(const int32_t acceleration, unitsnet_cpp::Frequency stepFrequency,
+                                        const uint16_t threshold, const int32_t maximumDistance,
+                                        const int32_t homePosition)
+    {
+        if ((this->_homingState == hsAccelerating) || (this->_homingState == hsSearching) ||
+            (this->_homingState == hsStopping))
+        {
+            return false;
+        }
+        log_info("TMC5130 #%d: Sensorless homing, threshold %d", this->_motor->ChipID, threshold);
+        this->_homingThreshold = threshold;
+        this->_homingMaximumDistance = maximumDistance;
+        this->_homePosition = homePosition;
+        this->_homingDeceleration = acceleration;
+        this->_homingHits = 0;
+        this->_homingStart = this->_motor->ReadActualPosition();
+        this->_homingState = hsAccelerating;
+        this->_motor->StartConstantVelocity(acceleration, stepFrequency);
+        return true;
+    }
+
+    void TMC5130StallGuard::AbortHoming()
+    {
+        if ((this->_homingState == hsAccelerating) || (this->_homingState == hsSearching))
+        {
+            this->_motor->StopMovement(this->_homingDeceleration);
+        }
+        if (this->_homingState == hsSearching)
+        {
+            _releaseStallStop();
+        }
+        this->_homingState = hsIdle;
+    }
+
+    HomingState_t TMC5130StallGuard::HomingState() const
+    {
+        return this->_homingState;
+    }
+
+    void TMC5130StallGuard::_homingStep()
+    {
+        const MotorState_t motorState = this->_motor->MotorState;
+        switch (this->_homingState)
+        {
+        case hsAccelerating:
+            // stallGuard is not valid while accelerating
+            if (motorState == msConstantVelocity)
+            {
+                // Not during the ramp up, stallGuard2 gives no stable result there
+                this->_motor->WriteField(TMC5130Fields::SG_STOP, 1);
+                this->_homingState = hsSearching;
+            }
+            else if (motorState != msConstantVelocityRampUp)
+            {
+                _finishHoming(false); // stopped from elsewhere
+            }
+            break;
+        case hsSearching:
+            if (motorState != msConstantVelocity)
+            {
+                // The driver stopped the ramp on the stall. Reading RAMP_STAT cleared the stop event, so halt the
+                // ramp generator before sg_stop is released or the motor would start again.
+                const bool stalled = (motorState == msIdle) && (this->_motor->IntReason == irStalled);
+                this->_motor->StopMovement(this->_homingDeceleration);
+                _releaseStallStop();
+                if (stalled)
+                {
+                    this->_homingState = hsStopping;
+                }
+                else
+                {
+                    _finishHoming(false); // stopped from elsewhere
+                }
+                break;
+            }
+            if (std::abs(this->_motor->LastKnownPosition - this->_homingStart) > this->_homingMaximumDistance)
+            {
+                this->_motor->StopMovement(this->_homingDeceleration);
+                _releaseStallStop();
+                _finishHoming(false);
+                break;
+            }
+            // Two samples in a row, a single low reading can be noise
+            this->_homingHits = (this->_lastSample.SGResult <= this->_homingThreshold) ? this->_homingHits + 1 : 0;
+            if (this->_homingHits >= 2)
+            {
+                this->_motor->StopMovement(this->_homingDeceleration);
+                _releaseStallStop();
+                this->_homingState = hsStopping;
+            }
+            break;
+        case hsStopping:
+            if (motorState == msIdle)
+            {
+                this->_motor->SetActualPosition(this->_homePosition);
+                _finishHoming(true);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void TMC5130StallGuard::_releaseStallStop()
+    {
+        this->_motor->WriteField(TMC5130Fields::SG_STOP, 0);
+    }
+
+    void TMC5130StallGuard::_finishHoming(const bool homed)
+    {
+        this->_homingState = homed ? hsHomed : hsFailed;
+        log_info("TMC5130 #%d: Sensorless homing %s", this->_motor->ChipID, homed ? "done" : "failed");
+        if (this->HomingCompletedCallback) // check if callback was assigned
+        {
+            this->HomingCompletedCallback(*this, homed);
+        }
+    }
+} // namespace LowLevelEmbedded::Devices::MotorControllers
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "TMC5130.h"
+#include "../../../Utilities/LockFreeQueue.h"
+#include <Frequency.hpp>
+#include <functional>
+
+// Number of load samples kept for the application, must be a power of two
+#ifndef TMC5130_STALLGUARD_HISTORY_SIZE
+#define TMC5130_STALLGUARD_HISTORY_SIZE 64
+#endif
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    /// One DRV_STATUS reading
+    struct TMC5130LoadSample
+    {
+        uint32_t Time;      // Utility::timestamp when the sample was taken
+        uint16_t SGResult;  // stallGuard2 load measurement, 0 is the highest load
+        uint8_t CSActual;   // actual current scale set by coolStep (0..31)
+        bool Stalled;       // the stallGuard flag of DRV_STATUS
+    };
+
+    typedef enum
+    {
+        hsIdle,
+        hsAccelerating,
+        hsSearching,
+        hsStopping,
+        hsHomed,
+        hsFailed
+    } HomingState_t;
+
+    /**
+     * @class TMC5130StallGuard
+     * @brief stallGuard2 / coolStep load telemetry, SGT tuning and sensorless homing for one TMC5130.
+     *
+     * Every call of Sample reads DRV_STATUS once (two datagrams), stores SG_RESULT and CS_ACTUAL in a ring
+     * buffer that the application can drain with TryGetSample, updates a low-pass filtered load value and
+     * runs the SGT tuning and homing state machines. Call it as often as the bus allows while the motor
+     * moves, the motor's own PeriodicJob still has to run for the motion states.
+     *
+     * stallGuard2 only gives useful values above a minimum velocity and not in stealthChop mode, so tuning
+     * and stall detection only look at samples taken at constant velocity.
+     */
+    class TMC5130StallGuard
+    {
+    public:
+        static constexpr size_t HISTORY_SIZE = TMC5130_STALLGUARD_HISTORY_SIZE;
+
+        explicit TMC5130StallGuard(TMC5130* motor);
+
+        /// Reads DRV_STATUS and advances filtering, tuning and homing.
+        void Sample();
+
+        /// Takes the oldest sample from the history. \return false if there is none
+        bool TryGetSample(TMC5130LoadSample& sample);
+
+        /// Number of samples that were lost because the history was full
+        uint32_t DroppedSamples() const;
+
+        /// The last sample, also when the history has been drained
+        TMC5130LoadSample LastSample() const;
+
+        /// SG_RESULT after a first order low-pass filter
+        float FilteredSGResult() const;
+
+        /**
+         * Sets the low-pass filter of FilteredSGResult.
+         * @param weight the weight of a new sample, 1 disables filtering
+         */
+        void SetFilterWeight(float weight);
+
+        /**
+         * @brief Starts tuning SGT while the motor runs unloaded at constant velocity.
+         *
+         * SGT is stepped up or down (one step per settleSamples samples) until the filtered SG_RESULT lies
+         * within window of targetResult, starting from the SGT currently configured in the driver. The motor
+         * must already be running when the tuning starts.
+         *
+         * @return false if the motor is not running at constant velocity
+         */
+        bool StartSGTTuning(uint16_t targetResult = 250, uint16_t window = 50, uint8_t settleSamples = 16);
+
+        bool IsTuningSGT() const;
+
+        /// The SGT value of the last SetSGT or tuning step, or the configured value read when tuning started
+        int8_t SGT() const;
+
+        void SetSGT(int8_t sgt);
+
+        /**
+         * @brief Homes the axis without switches: moves until the motor stalls.
+         *
+         * Once the motor runs at constant velocity sg_stop is enabled, so the driver stops the ramp in hardware
+         * on the stallGuard2 stall flag (set by SGT) without a braking distance. The driver ignores stalls below
+         * the coolStep threshold, so Configure_CoolStepThreshold must be below the homing velocity. As a
+         * fallback the motor is ramped down by software when SG_RESULT stays at or below threshold. Once the
+         * motor stands still its position is set to homePosition and sg_stop is disabled again.
+         * HomingCompletedCallback is called on success and on failure (no stall within maximumDistance).
+         *
+         * @param acceleration The acceleration in pulses per second squared.
+         * @param stepFrequency The homing velocity, the sign gives the direction.
+         * @param threshold The software fallback stops when SG_RESULT is at or below this value for two samples.
+         * @param maximumDistance The distance in steps after which homing fails.
+         * @param homePosition The position assigned to the stall point.
+         * @return false if homing is already running
+         */
+        bool StartHoming(int32_t acceleration, unitsnet_cpp::Frequency stepFrequency, uint16_t threshold,
+                         int32_t maximumDistance, int32_t homePosition = 0);
+
+        void AbortHoming();
+
+        HomingState_t HomingState() const;
+
+        std::function<void(TMC5130StallGuard&, bool homed)> HomingCompletedCallback;
+
+    private:
+        TMC5130* _motor;
+        Utility::LockFreeQueue<TMC5130LoadSample, HISTORY_SIZE> _history;
+        uint32_t _droppedSamples = 0;
+        TMC5130LoadSample _lastSample = {};
+        float _filteredSGResult = 0.0f;
+        float _filterWeight = 0.25f;
+        bool _filterPrimed = false;
+        int8_t _sgt = 0;
+
+        bool _tuning = false;
+        uint16_t _tuneTarget = 0;
+        uint16_t _tuneWindow = 0;
+        uint8_t _tuneSettleSamples = 0;
+        uint8_t _tuneSampleCount = 0;
+        int8_t _tuneLastDirection = 0;
+
+        HomingState_t _homingState = hsIdle;
+        uint16_t _homingThreshold = 0;
+        uint8_t _homingHits = 0;
+        int32_t _homingStart = 0;
+        int32_t _homingMaximumDistance = 0;
+        int32_t _homePosition = 0;
+        int32_t _homingDeceleration = 0;
+
+        void _tuneStep();
+        void _homingStep();
+        void _finishHoming(bool homed);
+        void _releaseStallStop();
+    };
+} // namespace LowLevelEmbedded::Devices::MotorControllers
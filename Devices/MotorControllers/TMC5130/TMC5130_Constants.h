@@ -18,6 +18,7 @@
 
 
 #define TMC5130_REGISTER_COUNT   TMC_REGISTER_COUNT
+#define TMC5130_SHADOW_REGISTER_COUNT 41 // registers with a write side, checked against the access table
 #define TMC5130_MOTORS           1
 #define TMC5130_WRITE_BIT        TMC_WRITE_BIT
 #define TMC5130_ADDRESS_MASK     TMC_ADDRESS_MASK
@@ -30,6 +31,16 @@
 #define TMC5130_MODE_VELNEG    2
 #define TMC5130_MODE_HOLD      3
 
+// SPI_STATUS bits, returned in the first byte of every datagram
+#define TMC5130_SPI_STATUS_RESET_FLAG        0x01
+#define TMC5130_SPI_STATUS_DRIVER_ERROR      0x02
+#define TMC5130_SPI_STATUS_SG2               0x04
+#define TMC5130_SPI_STATUS_STANDSTILL        0x08
+#define TMC5130_SPI_STATUS_VELOCITY_REACHED  0x10
+#define TMC5130_SPI_STATUS_POSITION_REACHED  0x20
+#define TMC5130_SPI_STATUS_STOP_L            0x40
+#define TMC5130_SPI_STATUS_STOP_R            0x80
+
 // limit switch mode bits (Register TMC5130_SWMODE)
 #define TMC5130_SW_STOPL_ENABLE    0x0001
 #define TMC5130_SW_STOPR_ENABLE    0x0002
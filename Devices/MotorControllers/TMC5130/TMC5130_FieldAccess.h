@@ -0,0 +1,134 @@
+#pragma once
+
+#include "TMC5130_Fields.h"
+#include "TMC5130_Register.h"
+
+#include <bit>
+#include <cstdint>
+
+namespace LowLevelEmbedded::Devices::MotorControllers
+{
+    /**
+     * @struct TMC5130Field
+     * @brief A bit field of a TMC5130 register: the register address plus the mask/shift pair of TMC5130_Fields.h.
+     *
+     * Descriptors are built with MakeField, which rejects masks that do not match their shift at compile time,
+     * and FitsValue can be used in a static_assert to check a constant against the field width.
+     */
+    struct TMC5130Field
+    {
+        uint8_t Address;
+        uint32_t Mask;
+        uint8_t Shift;
+        bool IsSigned;
+
+        constexpr uint8_t Width() const
+        {
+            return static_cast<uint8_t>(std::popcount(Mask));
+        }
+
+        constexpr int32_t MinValue() const
+        {
+            return IsSigned ? -(int32_t(1) << (Width() - 1)) : 0;
+        }
+
+        constexpr int32_t MaxValue() const
+        {
+            return IsSigned ? (int32_t(1) << (Width() - 1)) - 1 : static_cast<int32_t>(Mask >> Shift);
+        }
+
+        constexpr bool FitsValue(const int32_t value) const
+        {
+            return (value >= MinValue()) && (value <= MaxValue());
+        }
+
+        /// Extracts the field from a register value, sign extended for signed fields
+        constexpr int32_t Get(const int32_t registerValue) const
+        {
+            const uint32_t raw = (static_cast<uint32_t>(registerValue) & Mask) >> Shift;
+            if (IsSigned && ((raw >> (Width() - 1)) & 1))
+            {
+                return static_cast<int32_t>(raw) - (int32_t(1) << Width());
+            }
+            return static_cast<int32_t>(raw);
+        }
+
+        /// Returns the register value with the field replaced, bits outside the field width are dropped
+        constexpr int32_t Set(const int32_t registerValue, const int32_t value) const
+        {
+            return static_cast<int32_t>((static_cast<uint32_t>(registerValue) & ~Mask) |
+                                        ((static_cast<uint32_t>(value) << Shift) & Mask));
+        }
+    };
+
+    namespace TMC5130FieldDetail
+    {
+        // Not constexpr: reaching it during constant evaluation makes the field definition ill-formed
+        inline void invalidFieldMask() {}
+
+        consteval TMC5130Field MakeField(const uint8_t address, const uint32_t mask, const uint8_t shift,
+                                         const bool isSigned = false)
+        {
+            const uint32_t bits = mask >> shift;
+            // The mask must be one contiguous run of bits starting at the shift
+            if ((mask == 0) || ((bits & 1) == 0) || ((bits & (bits + 1)) != 0) || ((bits << shift) != mask))
+            {
+                invalidFieldMask();
+            }
+            return TMC5130Field{address, mask, shift, isSigned};
+        }
+    }
+
+    // The fields used by the driver, generated from the *_FIELD macros of TMC5130_Fields.h
+    namespace TMC5130Fields
+    {
+        using TMC5130FieldDetail::MakeField;
+
+        // GCONF
+        inline constexpr TMC5130Field I_SCALE_ANALOG = MakeField(TMC5130_GCONF, TMC5130_I_SCALE_ANALOG_FIELD);
+        inline constexpr TMC5130Field INTERNAL_RSENSE = MakeField(TMC5130_GCONF, TMC5130_INTERNAL_RSENSE_FIELD);
+        inline constexpr TMC5130Field EN_PWM_MODE = MakeField(TMC5130_GCONF, TMC5130_EN_PWM_MODE_FIELD);
+        inline constexpr TMC5130Field SHAFT = MakeField(TMC5130_GCONF, TMC5130_SHAFT_FIELD);
+        inline constexpr TMC5130Field DIAG0_STALL = MakeField(TMC5130_GCONF, TMC5130_DIAG0_STALL_FIELD);
+        inline constexpr TMC5130Field DIAG1_STALL = MakeField(TMC5130_GCONF, TMC5130_DIAG1_STALL_FIELD);
+        inline constexpr TMC5130Field DIAG0_INT_PUSHPULL = MakeField(TMC5130_GCONF, TMC5130_DIAG0_INT_PUSHPULL_FIELD);
+        inline constexpr TMC5130Field DIAG1_POSCOMP_PUSHPULL =
+            MakeField(TMC5130_GCONF, TMC5130_DIAG1_POSCOMP_PUSHPULL_FIELD);
+
+        // IHOLD_IRUN, TPOWERDOWN
+        inline constexpr TMC5130Field IHOLD = MakeField(TMC5130_IHOLD_IRUN, TMC5130_IHOLD_FIELD);
+        inline constexpr TMC5130Field IRUN = MakeField(TMC5130_IHOLD_IRUN, TMC5130_IRUN_FIELD);
+        inline constexpr TMC5130Field IHOLDDELAY = MakeField(TMC5130_IHOLD_IRUN, TMC5130_IHOLDDELAY_FIELD);
+        inline constexpr TMC5130Field TPOWERDOWN = MakeField(TMC5130_TPOWERDOWN, TMC5130_TPOWERDOWN_FIELD);
+
+        // Ramp generator
+        inline constexpr TMC5130Field V1 = MakeField(TMC5130_V1, TMC5130_V1_FIELD);
+        inline constexpr TMC5130Field VMAX = MakeField(TMC5130_VMAX, TMC5130_VMAX_FIELD);
+
+        // SW_MODE
+        inline constexpr TMC5130Field SG_STOP = MakeField(TMC5130_SWMODE, TMC5130_SG_STOP_FIELD);
+
+        // CHOPCONF
+        inline constexpr TMC5130Field TOFF = MakeField(TMC5130_CHOPCONF, TMC5130_TOFF_FIELD);
+        inline constexpr TMC5130Field HSTRT = MakeField(TMC5130_CHOPCONF, TMC5130_HSTRT_FIELD);
+        inline constexpr TMC5130Field HEND = MakeField(TMC5130_CHOPCONF, TMC5130_HEND_FIELD);
+        inline constexpr TMC5130Field TBL = MakeField(TMC5130_CHOPCONF, TMC5130_TBL_FIELD);
+        inline constexpr TMC5130Field VSENSE = MakeField(TMC5130_CHOPCONF, TMC5130_VSENSE_FIELD);
+        inline constexpr TMC5130Field MRES = MakeField(TMC5130_CHOPCONF, TMC5130_MRES_FIELD);
+
+        // COOLCONF
+        inline constexpr TMC5130Field SEMIN = MakeField(TMC5130_COOLCONF, TMC5130_SEMIN_FIELD);
+        inline constexpr TMC5130Field SEUP = MakeField(TMC5130_COOLCONF, TMC5130_SEUP_FIELD);
+        inline constexpr TMC5130Field SEMAX = MakeField(TMC5130_COOLCONF, TMC5130_SEMAX_FIELD);
+        inline constexpr TMC5130Field SEDN = MakeField(TMC5130_COOLCONF, TMC5130_SEDN_FIELD);
+        inline constexpr TMC5130Field SEIMIN = MakeField(TMC5130_COOLCONF, TMC5130_SEIMIN_FIELD);
+        inline constexpr TMC5130Field SGT = MakeField(TMC5130_COOLCONF, TMC5130_SGT_FIELD, true);
+        inline constexpr TMC5130Field SFILT = MakeField(TMC5130_COOLCONF, TMC5130_SFILT_FIELD);
+
+        // DRV_STATUS
+        inline constexpr TMC5130Field SG_RESULT = MakeField(TMC5130_DRVSTATUS, TMC5130_SG_RESULT_FIELD);
+        inline constexpr TMC5130Field CS_ACTUAL = MakeField(TMC5130_DRVSTATUS, TMC5130_CS_ACTUAL_FIELD);
+        inline constexpr TMC5130Field STALLGUARD = MakeField(TMC5130_DRVSTATUS, TMC5130_STALLGUARD_FIELD);
+        inline constexpr TMC5130Field STST = MakeField(TMC5130_DRVSTATUS, TMC5130_STST_FIELD);
+    }
+}
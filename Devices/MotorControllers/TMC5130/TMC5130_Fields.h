@@ -234,7 +234,7 @@
 #define TMC5130_IHOLD_FIELD TMC5130_IHOLD_MASK, TMC5130_IHOLD_SHIFT
 #define TMC5130_IRUN_MASK                             0x1F00 // IHOLD_IRUN // Motor run current (0=1/32...31=32/32) Hint: Choose sense resistors in a way, that normal IRUN is 16 to 31 for best microstep performance.
 #define TMC5130_IRUN_SHIFT                            8 // min.: 0, max.: 31, default: 0
-#define TMC5130_IRUN_FIELD TMC5130_IRUN_MASK\, TMC5130_IRUN_SHIFT
+#define TMC5130_IRUN_FIELD TMC5130_IRUN_MASK, TMC5130_IRUN_SHIFT
 #define TMC5130_IHOLDDELAY_MASK                       0x0F0000 // IHOLD_IRUN // Controls the number of clock cycles for motor power down after standstill is detected (stst=1) and TPOWERDOWN has expired. The smooth transition avoids a motor jerk upon power down. 0:  instant power down 1..15:  Delay per current reduction step in multiple of 2^18 clocks
 #define TMC5130_IHOLDDELAY_SHIFT                      16 // min.: 0, max.: 15, default: 0
 #define TMC5130_IHOLDDELAY_FIELD TMC5130_IHOLDDELAY_MASK, TMC5130_IHOLDDELAY_SHIFT
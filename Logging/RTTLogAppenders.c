@@ -1,14 +1,157 @@
 #include "RTTLogAppenders.h"
 #include "SEGGER_RTT.h"
+#include <stdatomic.h>
+#include <string.h>
 #include <ulog.h>
 
+#define RTT_LOG_QUEUE_INDEX_MASK ((uint32_t)(RTT_LOG_QUEUE_SLOT_COUNT - 1))
+
+_Static_assert((RTT_LOG_QUEUE_SLOT_COUNT & (RTT_LOG_QUEUE_SLOT_COUNT - 1)) == 0,
+               "RTT_LOG_QUEUE_SLOT_COUNT must be a power of two");
+_Static_assert(RTT_LOG_QUEUE_MESSAGE_SIZE > 1, "RTT_LOG_QUEUE_MESSAGE_SIZE is too small");
+
+// Bounded multi-producer queue (D. Vyukov). Each slot carries a sequence number that tells
+// producers and the consumer whose turn it is, so a producer interrupted while filling its slot
+// never blocks other producers: they simply reserve the next slot.
+// The sequence is stored relative to the slot index, which makes the zero-initialised state valid
+// and allows logging before any init function has run.
+typedef struct
+{
+  atomic_uint_fast32_t sequence;
+  uint32_t length;
+  char text[RTT_LOG_QUEUE_MESSAGE_SIZE];
+} RTTLogQueueSlot;
+
+static RTTLogQueueSlot _slots[RTT_LOG_QUEUE_SLOT_COUNT];
+static atomic_uint_fast32_t _head;
+static uint32_t _tail; // only touched by the (single) consumer
+static uint32_t _reportedDropped;
+
+static atomic_uint_fast32_t _queued;
+static atomic_uint_fast32_t _written;
+static atomic_uint_fast32_t _dropped;
+static atomic_uint_fast32_t _rttOverflows;
+
+static inline uint32_t slotSequence(RTTLogQueueSlot *slot, uint32_t index)
+{
+  return (uint32_t)atomic_load_explicit(&slot->sequence, memory_order_acquire) + index;
+}
+
+static inline void setSlotSequence(RTTLogQueueSlot *slot, uint32_t index, uint32_t sequence)
+{
+  atomic_store_explicit(&slot->sequence, sequence - index, memory_order_release);
+}
+
+static uint32_t formatEvent(ulog_Event *ev, char *buffer, size_t size)
+{
+  // leave room for the line feed
+  if (ulog_event_to_cstr(ev, buffer, size - 1) != 0)
+  {
+    return 0;
+  }
+  size_t length = strlen(buffer);
+  buffer[length++] = '\n';
+  buffer[length] = 0;
+  return (uint32_t)length;
+}
+
 void MicrologAnsiColorRTTOutput_callback(ulog_Event *ev, void *arg)
 {
-  static char buffer[160];
-  const int result = ulog_event_to_cstr(ev, buffer, sizeof(buffer));
-  if (result == 0)
+  (void)arg;
+  char buffer[RTT_LOG_QUEUE_MESSAGE_SIZE];
+  const uint32_t length = formatEvent(ev, buffer, sizeof(buffer));
+  if (length > 0)
+  {
+    SEGGER_RTT_Write(0, buffer, length);
+  }
+}
+
+void MicrologAnsiColorRTTQueuedOutput_callback(ulog_Event *ev, void *arg)
+{
+  (void)arg;
+  RTTLogQueueSlot *slot;
+  uint32_t index;
+  uint32_t position = (uint32_t)atomic_load_explicit(&_head, memory_order_relaxed);
+
+  // Reserve a slot
+  for (;;)
+  {
+    index = position & RTT_LOG_QUEUE_INDEX_MASK;
+    slot = &_slots[index];
+    const int32_t difference = (int32_t)(slotSequence(slot, index) - position);
+    if (difference == 0)
+    {
+      uint_fast32_t expected = position;
+      if (atomic_compare_exchange_weak_explicit(&_head, &expected, position + 1, memory_order_relaxed,
+                                                memory_order_relaxed))
+      {
+        break;
+      }
+      position = (uint32_t)expected;
+    }
+    else if (difference < 0)
+    {
+      // the consumer has not released this slot yet: queue is full
+      atomic_fetch_add_explicit(&_dropped, 1, memory_order_relaxed);
+      return;
+    }
+    else
+    {
+      // another producer took this slot, retry with the new head
+      position = (uint32_t)atomic_load_explicit(&_head, memory_order_relaxed);
+    }
+  }
+
+  slot->length = formatEvent(ev, slot->text, sizeof(slot->text));
+  atomic_fetch_add_explicit(&_queued, 1, memory_order_relaxed);
+
+  // Publish to the consumer
+  setSlotSequence(slot, index, position + 1);
+}
+
+uint32_t RTTLogQueue_Drain(uint32_t maxMessages)
+{
+  uint32_t count = 0;
+
+  const uint32_t dropped = (uint32_t)atomic_load_explicit(&_dropped, memory_order_relaxed);
+  if (dropped != _reportedDropped)
   {
-    SEGGER_RTT_WriteString(0, buffer);
-    SEGGER_RTT_WriteString(0, "\n");
+    SEGGER_RTT_printf(RTT_LOG_QUEUE_BUFFER_INDEX, "<%u log messages dropped>\n",
+                      (unsigned)(dropped - _reportedDropped));
+    _reportedDropped = dropped;
   }
-}
\ No newline at end of file
+
+  while ((maxMessages == 0) || (count < maxMessages))
+  {
+    const uint32_t index = _tail & RTT_LOG_QUEUE_INDEX_MASK;
+    RTTLogQueueSlot *slot = &_slots[index];
+    if ((int32_t)(slotSequence(slot, index) - (_tail + 1)) < 0)
+    {
+      break; // empty, or the producer of this slot is still formatting
+    }
+
+    if (slot->length > 0)
+    {
+      if (SEGGER_RTT_Write(RTT_LOG_QUEUE_BUFFER_INDEX, slot->text, slot->length) < slot->length)
+      {
+        atomic_fetch_add_explicit(&_rttOverflows, 1, memory_order_relaxed);
+      }
+    }
+
+    // Hand the slot back to the producers for the next lap
+    setSlotSequence(slot, index, _tail + RTT_LOG_QUEUE_SLOT_COUNT);
+    _tail++;
+    count++;
+  }
+
+  atomic_fetch_add_explicit(&_written, count, memory_order_relaxed);
+  return count;
+}
+
+void RTTLogQueue_GetStatistics(RTTLogQueue_Statistics *statistics)
+{
+  statistics->Queued = (uint32_t)atomic_load_explicit(&_queued, memory_order_relaxed);
+  statistics->Written = (uint32_t)atomic_load_explicit(&_written, memory_order_relaxed);
+  statistics->Dropped = (uint32_t)atomic_load_explicit(&_dropped, memory_order_relaxed);
+  statistics->RTTOverflows = (uint32_t)atomic_load_explicit(&_rttOverflows, memory_order_relaxed);
+}
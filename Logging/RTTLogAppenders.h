@@ -5,11 +5,51 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
 #include "ulog.h"
 #include "SEGGER_RTT.h"
 
+// Number of message slots in the queued appender, must be a power of two
+#ifndef RTT_LOG_QUEUE_SLOT_COUNT
+  #define RTT_LOG_QUEUE_SLOT_COUNT      (16)
+#endif
+
+// Maximum length of one formatted log message (including the terminating zero)
+#ifndef RTT_LOG_QUEUE_MESSAGE_SIZE
+  #define RTT_LOG_QUEUE_MESSAGE_SIZE    (160)
+#endif
+
+// RTT up-buffer the queued appender is drained into
+#ifndef RTT_LOG_QUEUE_BUFFER_INDEX
+  #define RTT_LOG_QUEUE_BUFFER_INDEX    (0)
+#endif
+
+typedef struct
+{
+  uint32_t Queued;        // messages accepted by the queue
+  uint32_t Written;       // messages written to RTT by RTTLogQueue_Drain
+  uint32_t Dropped;       // messages discarded because every slot was in use
+  uint32_t RTTOverflows;  // messages RTT could not store completely (up-buffer full)
+} RTTLogQueue_Statistics;
+
+/// Formats the event and writes it to RTT up-buffer 0.
+/// RTT access is serialised by SEGGER_RTT_LOCK, so this blocks interrupts while the message is copied.
 void MicrologAnsiColorRTTOutput_callback(ulog_Event *ev, void *arg);
 
+/// Formats the event into a free slot of a lock-free multi-producer queue, without touching RTT.
+/// Safe to call from any task or interrupt priority; when the queue is full the message is dropped and counted.
+/// The queue must be emptied by calling RTTLogQueue_Drain from a low-priority task.
+void MicrologAnsiColorRTTQueuedOutput_callback(ulog_Event *ev, void *arg);
+
+/// Writes queued messages to RTT, oldest first. Must only be called from a single consumer context.
+/// A notice is written whenever messages were dropped since the previous drain.
+/// \param maxMessages the maximum number of messages to write, 0 to write everything that is queued
+/// \return the number of messages written
+uint32_t RTTLogQueue_Drain(uint32_t maxMessages);
+
+/// Returns a snapshot of the queue counters.
+void RTTLogQueue_GetStatistics(RTTLogQueue_Statistics *statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,116 @@
+#include "RTTTelemetry.h"
+#include "SEGGER_RTT.h"
+#include "../Utilities/Delay.h"
+#include <atomic>
+#include <cstring>
+
+namespace LowLevelEmbedded::Logging
+{
+    namespace
+    {
+        uint8_t telemetryBuffer[SEGGER_RTT_TELEMETRY_BUFFER_SIZE];
+        std::atomic<uint32_t> droppedRecords { 0 };
+
+        inline void putUInt32(uint8_t* destination, const uint32_t value)
+        {
+            destination[0] = static_cast<uint8_t>(value);
+            destination[1] = static_cast<uint8_t>(value >> 8);
+            destination[2] = static_cast<uint8_t>(value >> 16);
+            destination[3] = static_cast<uint8_t>(value >> 24);
+        }
+
+        inline void putFloat(uint8_t* destination, const float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            putUInt32(destination, bits);
+        }
+    }
+
+    static_assert(SEGGER_RTT_TELEMETRY_BUFFER_INDEX < SEGGER_RTT_MAX_NUM_UP_BUFFERS,
+                  "SEGGER_RTT_TELEMETRY_BUFFER_INDEX exceeds SEGGER_RTT_MAX_NUM_UP_BUFFERS");
+
+    bool RTTTelemetry::Init()
+    {
+        return SEGGER_RTT_ConfigUpBuffer(SEGGER_RTT_TELEMETRY_BUFFER_INDEX, "Telemetry", telemetryBuffer,
+                                         sizeof(telemetryBuffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP) >= 0;
+    }
+
+    bool RTTTelemetry::WriteRecord(const uint8_t type, const uint8_t* payload, const uint8_t length)
+    {
+        if (length > MAX_PAYLOAD_SIZE)
+        {
+            return false;
+        }
+
+        uint8_t frame[HEADER_SIZE + MAX_PAYLOAD_SIZE + 1];
+        frame[0] = SYNC_BYTE;
+        frame[1] = type;
+        frame[2] = length;
+        putUInt32(&frame[3], Utility::timestamp ? Utility::timestamp() : 0);
+        std::memcpy(&frame[HEADER_SIZE], payload, length);
+
+        const size_t checksumIndex = HEADER_SIZE + length;
+        uint8_t checksum = 0;
+        for (size_t i = 1; i < checksumIndex; i++)
+        {
+            checksum += frame[i];
+        }
+        frame[checksumIndex] = checksum;
+
+        // In skip mode RTT stores the complete frame or nothing, so the stream never contains partial records
+        if (SEGGER_RTT_Write(SEGGER_RTT_TELEMETRY_BUFFER_INDEX, frame, checksumIndex + 1) == 0)
+        {
+            droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    bool RTTTelemetry::WritePowerSample(
+        const uint8_t source,
+        const unitsnet_cpp::ElectricCurrent current,
+        const unitsnet_cpp::ElectricPotential busVoltage,
+        const unitsnet_cpp::Power power)
+    {
+        uint8_t payload[13];
+        payload[0] = source;
+        putFloat(&payload[1], current.amperes());
+        putFloat(&payload[5], busVoltage.volts());
+        putFloat(&payload[9], power.watts());
+        return WriteRecord(static_cast<uint8_t>(TelemetryRecordType::PowerMonitor), payload, sizeof(payload));
+    }
+
+    bool RTTTelemetry::WriteADCSample(const uint8_t source, const uint8_t channel, const uint32_t rawValue,
+                                      const uint8_t status)
+    {
+        uint8_t payload[7] = { source, channel, status };
+        putUInt32(&payload[3], rawValue);
+        return WriteRecord(static_cast<uint8_t>(TelemetryRecordType::ADCConversion), payload, sizeof(payload));
+    }
+
+    bool RTTTelemetry::WriteEncoderPosition(const uint8_t source, const uint16_t position,
+                                            const uint8_t magneticStrength, const uint8_t flags)
+    {
+        uint8_t payload[5] = {
+            source,
+            static_cast<uint8_t>(position),
+            static_cast<uint8_t>(position >> 8),
+            magneticStrength,
+            flags
+        };
+        return WriteRecord(static_cast<uint8_t>(TelemetryRecordType::EncoderPosition), payload, sizeof(payload));
+    }
+
+    bool RTTTelemetry::WriteMotorPosition(const uint8_t source, const uint8_t motorState, const int32_t position)
+    {
+        uint8_t payload[6] = { source, motorState };
+        putUInt32(&payload[2], static_cast<uint32_t>(position));
+        return WriteRecord(static_cast<uint8_t>(TelemetryRecordType::MotorPosition), payload, sizeof(payload));
+    }
+
+    uint32_t RTTTelemetry::DroppedRecords()
+    {
+        return droppedRecords.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ElectricCurrent.hpp>
+#include <ElectricPotential.hpp>
+#include <Power.hpp>
+
+namespace LowLevelEmbedded::Logging
+{
+    /// Record types of the telemetry stream, see Tools/RTTTelemetryToCsv.py for the host side decoder
+    enum class TelemetryRecordType : uint8_t
+    {
+        PowerMonitor = 0x01, // source, current [A], bus voltage [V], power [W] (float32)
+        ADCConversion = 0x02, // source, channel, status, raw value (uint32)
+        EncoderPosition = 0x03, // source, position (uint16), magnetic strength, status flags
+        MotorPosition = 0x04, // source, motor state, actual position (int32)
+    };
+
+    /**
+     * @class RTTTelemetry
+     * @brief Streams compact, timestamped binary sample records through a dedicated SEGGER RTT up-buffer.
+     *
+     * Every record is framed as:
+     *   sync (0xA5) | type | payload length | timestamp (uint32) | payload | checksum
+     * The timestamp is Utility::timestamp, the host converts it with the tick rate it is given.
+     * Multi-byte values are little endian. The checksum is the 8-bit sum of all bytes from type up to the
+     * end of the payload, so the host can re-synchronise after a lost record.
+     *
+     * The up-buffer index and size are configured with SEGGER_RTT_TELEMETRY_BUFFER_INDEX and
+     * SEGGER_RTT_TELEMETRY_BUFFER_SIZE in SEGGER_RTT_Conf.h. The buffer runs in skip mode: a record that does
+     * not fit is dropped as a whole (and counted), the caller is never blocked.
+     */
+    class RTTTelemetry
+    {
+    public:
+        static constexpr uint8_t SYNC_BYTE = 0xA5;
+        static constexpr size_t HEADER_SIZE = 7;
+        static constexpr size_t MAX_PAYLOAD_SIZE = 16;
+
+        /// Configures the telemetry up-buffer. Must be called once before records are written.
+        /// \return true if the RTT buffer was configured
+        static bool Init();
+
+        static bool WritePowerSample(
+            uint8_t source,
+            unitsnet_cpp::ElectricCurrent current,
+            unitsnet_cpp::ElectricPotential busVoltage,
+            unitsnet_cpp::Power power);
+
+        static bool WriteADCSample(uint8_t source, uint8_t channel, uint32_t rawValue, uint8_t status);
+
+        static bool WriteEncoderPosition(uint8_t source, uint16_t position, uint8_t magneticStrength, uint8_t flags);
+
+        static bool WriteMotorPosition(uint8_t source, uint8_t motorState, int32_t position);
+
+        /// Writes a record with a caller-defined type (0x80..0xFF are reserved for applications)
+        /// \return true if the complete record was stored in the RTT buffer
+        static bool WriteRecord(uint8_t type, const uint8_t* payload, uint8_t length);
+
+        /// The number of records dropped because the up-buffer was full
+        static uint32_t DroppedRecords();
+    };
+}
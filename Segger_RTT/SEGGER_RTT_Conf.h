@@ -107,6 +107,18 @@ Revision: $Rev: 24316 $
   #define SEGGER_RTT_MODE_DEFAULT                   SEGGER_RTT_MODE_NO_BLOCK_SKIP // Mode for pre-initialized terminal channel (buffer 0)
 #endif
 
+//
+// Binary telemetry channel (Logging/RTTTelemetry)
+// Up-channel 1 is left free for SystemView.
+//
+#ifndef   SEGGER_RTT_TELEMETRY_BUFFER_INDEX
+  #define SEGGER_RTT_TELEMETRY_BUFFER_INDEX         (2)     // Up-buffer used for telemetry records                          (Default: 2)
+#endif
+
+#ifndef   SEGGER_RTT_TELEMETRY_BUFFER_SIZE
+  #define SEGGER_RTT_TELEMETRY_BUFFER_SIZE          (4096)  // Size of the telemetry up-buffer, larger buffers survive longer host poll gaps (Default: 4k)
+#endif
+
 /*********************************************************************
 *
 *       RTT memcpy configuration
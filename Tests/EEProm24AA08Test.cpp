@@ -0,0 +1,249 @@
+// Host test for EEProm24AA08, runs against a simulated 24AA08 on a fake II2CAccess.
+
+#include <cstdio>
+#include <cstring>
+
+#include "../Devices/EEProms/EEProm24AA08.h"
+#include "../Utilities/Delay.h"
+
+using namespace LowLevelEmbedded;
+using namespace LowLevelEmbedded::Devices::EEProm;
+
+#define CHECK(condition)                                                                \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(condition))                                                               \
+        {                                                                               \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);    \
+            failures++;                                                                 \
+        }                                                                               \
+    } while (0)
+
+namespace
+{
+    int failures = 0;
+
+    // Simulated time, advanced by Utility::Delay_us
+    uint64_t nowInus = 0;
+
+    /**
+     * 24AA08 model: four 256 byte blocks behind the device addresses 0xA0-0xA6, a page write wraps around inside
+     * its 16 byte page like the real device, and the device does not acknowledge anything for 5 ms after a
+     * page write. Every ready poll takes 100 us of bus time.
+     */
+    class FakeEEProm : public II2CAccess
+    {
+    public:
+        static constexpr uint64_t WRITE_CYCLE_US = 5000;
+        static constexpr uint64_t POLL_US = 100;
+
+        uint8_t Memory[EEProm24AA08::MEMORY_SIZE] = {};
+        int PageWrites = 0;
+        int Reads = 0;
+        int BusyNacks = 0;
+
+        bool I2C_ReadMethod(uint8_t, uint8_t*, size_t) override { return false; }
+        bool I2C_WriteMethod(uint8_t, uint8_t*, size_t) override { return false; }
+        bool I2C_ReadWriteMethod(uint8_t, uint8_t*, size_t, size_t) override { return false; }
+
+        bool I2C_Mem_Read(uint8_t address, uint8_t memAddress, uint8_t, uint8_t* data, size_t readLength) override
+        {
+            if (_busy()) return false;
+            Reads++;
+            // The address counter rolls over from the end of the block to its start
+            const size_t base = _blockBase(address);
+            for (size_t i = 0; i < readLength; i++)
+            {
+                data[i] = this->Memory[base + ((memAddress + i) % EEProm24AA08::BLOCK_SIZE)];
+            }
+            return true;
+        }
+
+        bool I2C_Mem_Write(uint8_t address, uint8_t memAddress, uint8_t, uint8_t* data, size_t writeLength) override
+        {
+            if (_busy()) return false;
+            PageWrites++;
+            const size_t page = _blockBase(address) + (memAddress & ~(EEProm24AA08::PAGE_SIZE - 1));
+            for (size_t i = 0; i < writeLength; i++)
+            {
+                this->Memory[page + ((memAddress + i) % EEProm24AA08::PAGE_SIZE)] = data[i];
+            }
+            this->_busyUntilInus = nowInus + WRITE_CYCLE_US;
+            return true;
+        }
+
+        bool I2C_IsDeviceReady(uint8_t) override
+        {
+            const bool ready = !_busy();
+            nowInus += POLL_US;
+            return ready;
+        }
+
+    private:
+        uint64_t _busyUntilInus = 0;
+
+        bool _busy()
+        {
+            if (nowInus < this->_busyUntilInus)
+            {
+                BusyNacks++;
+                return true;
+            }
+            return false;
+        }
+
+        static size_t _blockBase(uint8_t address)
+        {
+            return ((address >> 1) & 0x03) * EEProm24AA08::BLOCK_SIZE;
+        }
+    };
+
+    uint8_t pattern(size_t index)
+    {
+        // Differs between the blocks as well, so data in the wrong block shows
+        return static_cast<uint8_t>(index * 7 + (index / EEProm24AA08::BLOCK_SIZE) * 0x35 + 3);
+    }
+
+    void testWrite(uint16_t address, size_t length, int expectedPageWrites)
+    {
+        FakeEEProm fake;
+        std::memset(fake.Memory, 0xFF, sizeof(fake.Memory));
+        EEProm24AA08 eeprom(&fake);
+
+        uint8_t data[EEProm24AA08::MEMORY_SIZE];
+        for (size_t i = 0; i < length; i++) data[i] = pattern(i);
+
+        CHECK(eeprom.WriteBytes(address, data, length));
+        CHECK(fake.PageWrites == expectedPageWrites);
+        // The write only returns once the last page has finished its write cycle
+        CHECK(fake.I2C_IsDeviceReady(0xA0));
+        for (size_t i = 0; i < EEProm24AA08::MEMORY_SIZE; i++)
+        {
+            const bool written = (i >= address) && (i < address + length);
+            const uint8_t expected = written ? pattern(i - address) : 0xFF;
+            if (fake.Memory[i] != expected)
+            {
+                std::printf("write %u+%zu: byte %zu is 0x%02X, expected 0x%02X\n", address, length, i,
+                            fake.Memory[i], expected);
+                failures++;
+                break;
+            }
+        }
+    }
+
+    void testWrites()
+    {
+        // Aligned: one full page, several full pages
+        testWrite(0, 16, 1);
+        testWrite(32, 64, 4);
+        // Unaligned: inside one page, and crossing a page boundary
+        testWrite(5, 8, 1);
+        testWrite(5, 16, 2);
+        testWrite(1001, 20, 2);
+        // Crossing a block (I2C address) boundary
+        testWrite(250, 12, 2);
+        testWrite(500, 40, 3);
+        // The whole memory
+        testWrite(0, EEProm24AA08::MEMORY_SIZE, EEProm24AA08::MEMORY_SIZE / EEProm24AA08::PAGE_SIZE);
+    }
+
+    void testNonBlockingWrite()
+    {
+        FakeEEProm fake;
+        EEProm24AA08 eeprom(&fake);
+        uint8_t data[40];
+        for (size_t i = 0; i < sizeof(data); i++) data[i] = pattern(i);
+
+        CHECK(eeprom.StartWriteBytes(100, data, sizeof(data)));
+        CHECK(eeprom.IsWriting());
+        CHECK(fake.PageWrites == 1);
+        // A second write is refused while the first is in progress
+        CHECK(!eeprom.StartWriteBytes(0, data, 1));
+
+        int calls = 0;
+        EEProm24AA08_WriteStatus status = EEProm24AA08_WriteStatus::Busy;
+        while ((status == EEProm24AA08_WriteStatus::Busy) && (calls < 1000))
+        {
+            status = eeprom.ContinueWrite();
+            nowInus += 500;
+            calls++;
+        }
+        CHECK(status == EEProm24AA08_WriteStatus::Done);
+        CHECK(!eeprom.IsWriting());
+        CHECK(fake.PageWrites == 3);
+        CHECK(std::memcmp(&fake.Memory[100], data, sizeof(data)) == 0);
+    }
+
+    void testRead(uint16_t address, size_t length, int expectedReads)
+    {
+        FakeEEProm fake;
+        for (size_t i = 0; i < EEProm24AA08::MEMORY_SIZE; i++) fake.Memory[i] = pattern(i);
+        EEProm24AA08 eeprom(&fake);
+
+        // One guard byte behind the data, the read must not run past length
+        uint8_t data[EEProm24AA08::MEMORY_SIZE + 1];
+        std::memset(data, 0xA5, sizeof(data));
+        CHECK(eeprom.ReadBytes(address, data, length));
+        CHECK(fake.Reads == expectedReads);
+        CHECK(std::memcmp(data, &fake.Memory[address], length) == 0);
+        CHECK(data[length] == 0xA5);
+    }
+
+    void testReads()
+    {
+        // Inside one block, up to its last byte, and from its first byte
+        testRead(0, 16, 1);
+        testRead(200, 56, 1);
+        testRead(256, 256, 1);
+        // Crossing one and two block boundaries
+        testRead(250, 12, 2);
+        testRead(255, 258, 3);
+        // The whole memory is one sequential read per block
+        testRead(0, EEProm24AA08::MEMORY_SIZE, 4);
+
+        // The bytes on both sides of every block edge of a 1 KB read
+        FakeEEProm fake;
+        for (size_t i = 0; i < EEProm24AA08::MEMORY_SIZE; i++) fake.Memory[i] = pattern(i);
+        EEProm24AA08 eeprom(&fake);
+        uint8_t data[EEProm24AA08::MEMORY_SIZE] = {};
+        CHECK(eeprom.ReadBytes(0, data, sizeof(data)));
+        for (size_t edge = EEProm24AA08::BLOCK_SIZE; edge < EEProm24AA08::MEMORY_SIZE; edge += EEProm24AA08::BLOCK_SIZE)
+        {
+            CHECK(data[edge - 1] == pattern(edge - 1));
+            CHECK(data[edge] == pattern(edge));
+        }
+        CHECK(data[EEProm24AA08::MEMORY_SIZE - 1] == pattern(EEProm24AA08::MEMORY_SIZE - 1));
+    }
+
+    void testReadAfterWrite()
+    {
+        // A read right after StartWriteBytes completes the write first instead of reading a busy device
+        FakeEEProm fake;
+        EEProm24AA08 eeprom(&fake);
+        uint8_t data[20];
+        for (size_t i = 0; i < sizeof(data); i++) data[i] = pattern(i);
+        CHECK(eeprom.StartWriteBytes(10, data, sizeof(data)));
+
+        uint8_t readBack[sizeof(data)] = {};
+        CHECK(eeprom.ReadBytes(10, readBack, sizeof(readBack)));
+        CHECK(!eeprom.IsWriting());
+        CHECK(std::memcmp(readBack, data, sizeof(data)) == 0);
+    }
+}
+
+int main()
+{
+    Utility::Delay_us = [](uint32_t us) { nowInus += us; };
+    Utility::millis = []() { return static_cast<uint32_t>(nowInus / 1000); };
+
+    testWrites();
+    testNonBlockingWrite();
+    testReads();
+    testReadAfterWrite();
+
+    if (failures == 0)
+    {
+        std::printf("EEProm24AA08Test passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Converts a LowLevelEmbedded RTT telemetry stream (Logging/RTTTelemetry) to CSV files.
+
+Capture the telemetry up-buffer on the host, for example with
+    JLinkRTTLogger -Device <device> -If SWD -Speed 4000 -RTTChannel 2 telemetry.bin
+and convert it with
+    RTTTelemetryToCsv.py telemetry.bin --prefix capture --tick-rate 1000
+
+One CSV file is written per record type (capture_power.csv, capture_adc.csv, ...).
+Records with a bad checksum are skipped and the decoder re-synchronises on the next sync byte.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+SYNC_BYTE = 0xA5
+HEADER_SIZE = 7
+
+# type: (file suffix, column names, struct format of the payload)
+RECORD_TYPES = {
+    0x01: ("power", ["source", "current_A", "bus_voltage_V", "power_W"], "<Bfff"),
+    0x02: ("adc", ["source", "channel", "status", "raw"], "<BBBI"),
+    0x03: ("encoder", ["source", "position", "magnetic_strength", "flags"], "<BHBB"),
+    0x04: ("motor", ["source", "motor_state", "position"], "<BBi"),
+}
+
+
+def decode(data):
+    """Yields (type, timestamp, payload bytes) for every valid record in data."""
+    index = 0
+    end = len(data)
+    while index + HEADER_SIZE + 1 <= end:
+        if data[index] != SYNC_BYTE:
+            index += 1
+            continue
+        length = data[index + 2]
+        checksum_index = index + HEADER_SIZE + length
+        if checksum_index >= end:
+            # A sync byte inside a payload followed by a large length, or a record cut off at the end
+            index += 1
+            continue
+        if (sum(data[index + 1:checksum_index]) & 0xFF) != data[checksum_index]:
+            index += 1
+            continue
+        record_type = data[index + 1]
+        timestamp = struct.unpack_from("<I", data, index + 3)[0]
+        yield record_type, timestamp, bytes(data[index + HEADER_SIZE:checksum_index])
+        index = checksum_index + 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="binary capture of the telemetry up-buffer, '-' for stdin")
+    parser.add_argument("--prefix", default="telemetry", help="prefix of the generated CSV files")
+    parser.add_argument("--tick-rate", type=float, default=0.0,
+                        help="timestamp ticks per second; when given a time_s column is added")
+    args = parser.parse_args()
+
+    data = sys.stdin.buffer.read() if args.input == "-" else open(args.input, "rb").read()
+
+    files = {}
+    writers = {}
+    counts = {}
+    try:
+        for record_type, timestamp, payload in decode(data):
+            if record_type in RECORD_TYPES:
+                suffix, columns, fmt = RECORD_TYPES[record_type]
+                if struct.calcsize(fmt) != len(payload):
+                    continue
+                values = list(struct.unpack(fmt, payload))
+            else:
+                suffix, columns = "type%02X" % record_type, ["payload"]
+                values = [payload.hex()]
+
+            if suffix not in writers:
+                files[suffix] = open("%s_%s.csv" % (args.prefix, suffix), "w", newline="")
+                writers[suffix] = csv.writer(files[suffix])
+                header = ["timestamp"] + (["time_s"] if args.tick_rate > 0 else []) + columns
+                writers[suffix].writerow(header)
+                counts[suffix] = 0
+
+            row = [timestamp] + ([timestamp / args.tick_rate] if args.tick_rate > 0 else []) + values
+            writers[suffix].writerow(row)
+            counts[suffix] += 1
+    finally:
+        for f in files.values():
+            f.close()
+
+    for suffix, count in sorted(counts.items()):
+        print("%s_%s.csv: %d records" % (args.prefix, suffix, count))
+
+
+if __name__ == "__main__":
+    main()
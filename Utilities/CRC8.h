@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace LowLevelEmbedded::Utility
+{
+    /**
+     * Table driven CRC-8 (MSB first, not reflected, no final XOR).
+     *
+     * The 256 byte table is generated at compile time and lives in flash, a checksum then costs one table
+     * lookup per byte.
+     *
+     * @tparam Polynomial The generator polynomial without the x^8 term, e.g. 0x07 for x^8 + x^2 + x + 1.
+     */
+    template <uint8_t Polynomial>
+    class CRC8
+    {
+    private:
+        static constexpr std::array<uint8_t, 256> makeTable()
+        {
+            std::array<uint8_t, 256> table {};
+            for (size_t i = 0; i < table.size(); i++)
+            {
+                uint8_t crc = static_cast<uint8_t>(i);
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ Polynomial) : static_cast<uint8_t>(crc << 1);
+                }
+                table[i] = crc;
+            }
+            return table;
+        }
+
+        static constexpr std::array<uint8_t, 256> _table = makeTable();
+
+    public:
+        /// Calculates the CRC of a buffer.
+        /// \param crc the initial value, or the result of a previous call to continue a calculation
+        /// \return the CRC, 0 when the buffer ends with its own (correct) CRC and the initial value was 0
+        static constexpr uint8_t Compute(const uint8_t* data, size_t length, uint8_t crc = 0)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                crc = _table[crc ^ data[i]];
+            }
+            return crc;
+        }
+    };
+}
@@ -20,6 +20,11 @@ namespace LowLevelEmbedded
        /// returns the number of milliseconds since the system started
         inline std::function<uint32_t()> millis;
 
+        /// returns a free running high resolution counter, used to timestamp samples and telemetry records
+        /// Usage: LowLevelEmbedded::Utility::timestamp = ReadCycleCounter;
+        /// Any tick rate will do, when not assigned the timestamps are 0.
+        inline std::function<uint32_t()> timestamp;
+
         /// Delays in a UnitsNet-CPP Duration
         /// @param duration a UnitsNet-CPP Duration
         inline void Delay(const unitsnet_cpp::Duration duration)
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace LowLevelEmbedded::Utility
+{
+    /**
+     * Fixed-size single-producer/single-consumer ring buffer.
+     *
+     * Push and Pop never block and never disable interrupts, so one side can run in an interrupt handler and
+     * the other in a task. Only one context may push and only one context may pop.
+     *
+     * @tparam T The element type, copied in and out of the queue.
+     * @tparam Size The number of elements, must be a power of two.
+     */
+    template <typename T, size_t Size>
+    class LockFreeQueue
+    {
+        static_assert(Size > 0 && (Size & (Size - 1)) == 0, "LockFreeQueue size must be a power of two");
+
+    private:
+        static constexpr size_t INDEX_MASK = Size - 1;
+
+        std::array<T, Size> _items {};
+        std::atomic<size_t> _head { 0 }; // next position to write, owned by the producer
+        std::atomic<size_t> _tail { 0 }; // next position to read, owned by the consumer
+
+    public:
+        /// Adds an element (producer side).
+        /// \return false if the queue is full, the element is not added
+        bool Push(const T& item)
+        {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == Size)
+            {
+                return false;
+            }
+            _items[head & INDEX_MASK] = item;
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Removes the oldest element (consumer side).
+        /// \return false if the queue is empty
+        bool Pop(T& item)
+        {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            item = _items[tail & INDEX_MASK];
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// Copies the oldest element without removing it (consumer side).
+        /// \return false if the queue is empty
+        bool Peek(T& item) const
+        {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            item = _items[tail & INDEX_MASK];
+            return true;
+        }
+
+        /// Discards all elements (consumer side).
+        void Clear()
+        {
+            _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+        size_t Count() const
+        {
+            return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+        }
+
+        bool IsEmpty() const
+        {
+            return Count() == 0;
+        }
+
+        static constexpr size_t Capacity()
+        {
+            return Size;
+        }
+    };
+}
@@ -78,10 +78,8 @@ public:
         // Generate interpolated points
         for (size_t j = 0; j < extraPointsInThisGap; ++j) {
           T x = x1 + step * static_cast<T>(j + 1);
-          // Calculate the normalized position (t) between 0 and 1
-          T t = static_cast<T>(j + 1) / static_cast<T>(extraPointsInThisGap + 1);
-          // Use t to interpolate directly between y1 and y2
-          Y y = (1 - t) * y1 + t * y2;
+          // Interpolate on x itself, a normalized t between 0 and 1 truncates to 0 for integer (fixed point) tables
+          Y y = y1 + (x - x1) * (y2 - y1) / (x2 - x1);
           _data[currentDataIndex++] = DataPoint(x, y);
         }
       }